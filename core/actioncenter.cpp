@@ -4,44 +4,47 @@
 
 #include "actioncenter.h"
 
-#include "mousehandler.h"
+#include <algorithm>
+#include <cmath>
 #include <utility>
 
+#include "mousehandler.h"
+#include "time_utils.h"
+
 namespace stg {
 
 #pragma mark - Construction
 
     action_center::action_center(stg::strategy &strategy,
                                  std::function<gfloat()> slot_height_getter,
-                                 std::function<rect()> viewport_getter)
+                                 std::function<rect()> viewport_getter,
+                                 std::function<gfloat()> device_pixel_ratio_getter)
         : strategy(strategy),
+          get_slot_height(slot_height_getter),
+          get_device_pixel_ratio(std::move(device_pixel_ratio_getter)),
           _mouse_handler(strategy,
                          _selection,
                          std::move(slot_height_getter),
                          std::move(viewport_getter)) {
         _mouse_handler.action_center = this;
 
-        strategy.sessions().add_on_change_callback([this] {
+        sessions_connection = strategy.sessions().add_on_change_callback([this] {
             stg::timer::schedule(1, false, [this] { lazily_update_current_session(); });
-        });
-
-        auto timer_callback = [this] {
-            if (on_update_current_time_marker)
-                on_update_current_time_marker();
 
-            if (!this->strategy.is_dragging() && !this->strategy.is_resizing()) {
-                update_current_session();
-            }
-        };
+            // Session boundaries might have moved, so we need to re-arm the wakeup.
+            schedule_wakeup();
+        });
 
-        strategy.time_slots().add_on_ruler_change_callback([=] {
-            timer_callback();
+        ruler_connection = strategy.time_slots().add_on_ruler_change_callback([this] {
+            wakeup();
         });
 
-        auto timer_interval = 5;
-        timer = stg::timer::schedule(timer_interval, true, timer_callback);
+        wakeup();
+    }
 
-        timer_callback();
+    action_center::~action_center() {
+        if (timer)
+            timer->invalidate();
     }
 
 #pragma mark - Acessing Depenent Structures
@@ -94,4 +97,79 @@ namespace stg {
             stg::timer::schedule(1, false, [this] { lazily_update_current_session(); });
         }
     }
+
+#pragma mark - Scheduling Wakeups
+
+    auto action_center::seconds_until_next_wakeup() const -> stg::timer::seconds {
+        auto result = max_wakeup_interval;
+        auto take_if_sooner = [&result](stg::timer::seconds interval) {
+            if (interval > 0 && interval < result)
+                result = interval;
+        };
+
+        auto begin_seconds = (stg::timer::seconds) strategy.begin_time() * 60;
+        auto duration_seconds = (stg::timer::seconds) strategy.duration() * 60;
+
+        auto now = (stg::timer::seconds) time_utils::current_seconds();
+        if (strategy.end_time() > 24 * 60 && now < begin_seconds)
+            now += 24 * 3600;
+
+        // The next session boundary, at which current session changes.
+        for (const auto &session : strategy.sessions()) {
+            auto session_begin_seconds = (stg::timer::seconds) session.begin_time() * 60;
+            if (session_begin_seconds > now) {
+                take_if_sooner(session_begin_seconds - now);
+                break;
+            }
+        }
+
+        take_if_sooner(begin_seconds + duration_seconds - now);
+
+        // The next time the current time marker moves by one device pixel.
+        auto elapsed_seconds = now - begin_seconds;
+        if (get_slot_height &&
+            elapsed_seconds > 0 &&
+            elapsed_seconds < duration_seconds) {
+            auto device_pixel_ratio = get_device_pixel_ratio ? get_device_pixel_ratio() : 1;
+            auto marker_track_height = strategy.number_of_time_slots() * get_slot_height() * device_pixel_ratio;
+
+            if (marker_track_height > 0) {
+                auto seconds_per_pixel = duration_seconds / marker_track_height;
+                auto next_pixel = std::floor(elapsed_seconds / seconds_per_pixel) + 1;
+
+                take_if_sooner(next_pixel * seconds_per_pixel - elapsed_seconds);
+            }
+        }
+
+        // The next minute rollover, at which current session labels change.
+        if (strategy.active_session())
+            take_if_sooner(60 - std::fmod(now, 60));
+
+        return std::max(result, min_wakeup_interval);
+    }
+
+    void action_center::wakeup() {
+        if (on_update_current_time_marker)
+            on_update_current_time_marker();
+
+        if (!strategy.is_dragging() && !strategy.is_resizing()) {
+            update_current_session();
+        }
+
+        schedule_wakeup();
+    }
+
+    void action_center::schedule_wakeup() {
+        if (timer)
+            timer->invalidate();
+
+        timer = stg::timer::schedule(seconds_until_next_wakeup(), false, [this] {
+            timer = nullptr;
+
+            // Scheduled wakeups are sparse and always mean that something visible
+            // has changed, so they bypass current session reload throttling.
+            last_current_time_update_time = {};
+            wakeup();
+        });
+    }
 }
@@ -29,7 +29,10 @@ namespace stg {
 
         action_center(stg::strategy &strategy,
                       std::function<gfloat()> slot_height_getter,
-                      std::function<rect()> viewport_getter);
+                      std::function<rect()> viewport_getter,
+                      std::function<gfloat()> device_pixel_ratio_getter = nullptr);
+
+        ~action_center();
 
 #pragma mark - Acessing Depenent Structures
 
@@ -72,7 +75,7 @@ namespace stg {
 
         const action empty_selection{"Delete",
                                      [this] {
-                                         this->strategy.make_empty_at(_selection);
+                                         this->strategy.make_empty_at(_selection.indices());
                                          this->_selection.deselect_all();
                                      },
                                      [this] {
@@ -105,7 +108,7 @@ namespace stg {
                                                  [this] { this->strategy.reorder_activities_by_usage(); }};
 
         void place_activity_in_selection(index_t actvity_index) {
-            strategy.place_activity(actvity_index, _selection);
+            strategy.place_activity(actvity_index, _selection.indices());
             _selection.deselect_all();
 
             if (on_show_sessions) on_show_sessions();
@@ -115,18 +118,37 @@ namespace stg {
 
         auto current_session_is_shown() const -> bool;
 
+#pragma mark - Scheduling Wakeups
+
+        // Wakeups are never more than this far apart,
+        // so that we can recover from system time changes.
+        static constexpr stg::timer::seconds max_wakeup_interval = 5 * 60;
+        static constexpr stg::timer::seconds min_wakeup_interval = 0.05;
+
+        auto seconds_until_next_wakeup() const -> stg::timer::seconds;
+
     private:
         stg::strategy &strategy;
+
+        std::function<gfloat()> get_slot_height;
+        std::function<gfloat()> get_device_pixel_ratio;
+
         stg::mouse_handler _mouse_handler;
         stg::selection _selection{strategy};
 
         std::shared_ptr<stg::timer> timer;
 
+        scoped_connection sessions_connection;
+        scoped_connection ruler_connection;
+
         bool _current_session_is_shown = strategy.active_session() != nullptr;
         std::chrono::time_point<std::chrono::system_clock> last_current_time_update_time{};
 
         void update_current_session();
         void lazily_update_current_session();
+
+        void wakeup();
+        void schedule_wakeup();
     };
 }
 
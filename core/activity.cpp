@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <functional>
 #include <iostream>
 
 #include "activity.h"
@@ -31,6 +32,16 @@ namespace stg {
         return _name;
     }
 
+    auto activity::content_hash() const -> content_hash_t {
+        auto result = mix_hash(std::hash<std::string>()(_name));
+        result = combine_hash(result, _color.red());
+        result = combine_hash(result, _color.green());
+        result = combine_hash(result, _color.blue());
+        result = combine_hash(result, _color.alpha());
+
+        return result;
+    }
+
     auto activity::color() const -> const stg::color & {
         return _color;
     }
@@ -7,6 +7,7 @@
 #include <utility>
 
 #include "color.h"
+#include "stghash.h"
 
 namespace stg {
     struct activity {
@@ -23,6 +24,9 @@ namespace stg {
         auto name() const -> const std::string &;
         auto color() const -> const color &;
 
+        // Equal activities have equal hashes.
+        auto content_hash() const -> content_hash_t;
+
         auto with_name(const std::string &name) const -> activity;
         auto with_color(const stg::color &color) const -> activity;
 
@@ -0,0 +1,69 @@
+#ifndef STRATEGR_ACTIVITYID_H
+#define STRATEGR_ACTIVITYID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <tuple>
+
+#include "stghash.h"
+
+namespace stg {
+    // Stable handle of an activity in activity_list.
+    // The list bumps the generation whenever it reuses a place for another activity,
+    // so a stale handle never resolves to an activity it wasn't made for.
+    struct activity_id {
+        using index_t = uint32_t;
+        using generation_t = uint32_t;
+
+        index_t index = 0;
+
+        // Zero generation means no activity.
+        generation_t generation = 0;
+
+        constexpr activity_id() = default;
+        constexpr activity_id(std::nullptr_t) {}
+        constexpr activity_id(index_t index, generation_t generation)
+            : index(index),
+              generation(generation) {}
+
+        constexpr explicit operator bool() const {
+            return generation != 0;
+        }
+
+        auto content_hash() const -> content_hash_t {
+            return combine_hash(mix_hash(index), generation);
+        }
+
+        friend constexpr auto operator==(const activity_id &lhs, const activity_id &rhs) -> bool {
+            return lhs.index == rhs.index && lhs.generation == rhs.generation;
+        }
+
+        friend constexpr auto operator!=(const activity_id &lhs, const activity_id &rhs) -> bool {
+            return !(lhs == rhs);
+        }
+
+        friend auto operator<(const activity_id &lhs, const activity_id &rhs) -> bool {
+            return std::tie(lhs.index, lhs.generation) < std::tie(rhs.index, rhs.generation);
+        }
+
+        friend auto operator<<(std::ostream &os, const activity_id &id) -> std::ostream & {
+            if (!id)
+                return os << "none";
+
+            return os << "activity_id(" << id.index << ", " << id.generation << ")";
+        }
+    };
+}
+
+namespace std {
+    template<>
+    struct hash<stg::activity_id> {
+        auto operator()(const stg::activity_id &id) const -> size_t {
+            return static_cast<size_t>(id.content_hash());
+        }
+    };
+}
+
+#endif//STRATEGR_ACTIVITYID_H
@@ -4,6 +4,8 @@
 
 #include <algorithm>
 #include <regex>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "activitylist.h"
 #include "stgstring.h"
@@ -14,10 +16,16 @@ namespace stg {
             throw already_present_exception();
         }
 
-        _data.push_back(std::make_shared<stg::activity>(activity));
+        auto id = take_place(activity);
+        _data.push_back(id);
+        update_indices(size() - 1);
 
-        if (!search_query.empty())
-            search(search_query);
+        search_index.insert(get(id));
+
+        _content_hash += list_item_hash(_data.size() - 1, activity.content_hash());
+        _version = ++last_version;
+
+        refresh_search_results();
     }
 
     void activity_list::add(const activity &activity) {
@@ -27,10 +35,17 @@ namespace stg {
     }
 
     void activity_list::silently_remove_at_index(activity_index_t index) {
+        auto id = _data[index];
+
+        search_index.erase(get(id));
+        free_place(id);
+
         _data.erase(_data.begin() + index);
 
-        if (!search_query.empty())
-            search(search_query);
+        update_indices(index);
+        rehash();
+
+        refresh_search_results();
     }
 
     void activity_list::remove_at_index(activity_index_t index) {
@@ -40,7 +55,8 @@ namespace stg {
     }
 
     void activity_list::silently_edit_at_index(activity_index_t index, const activity &new_activity) {
-        if (*_data[index] == new_activity) {
+        auto *activity = at(index);
+        if (*activity == new_activity) {
             return;
         }
 
@@ -48,15 +64,21 @@ namespace stg {
             throw already_present_exception();
         }
 
-        _data[index] = std::make_shared<activity>(new_activity);
+        search_index.erase(activity);
 
-        if (!search_query.empty()) {
-            search(search_query);
-        }
+        _content_hash -= list_item_hash(index, activity->content_hash());
+        *activity = new_activity;
+        _content_hash += list_item_hash(index, activity->content_hash());
+
+        _version = ++last_version;
+
+        search_index.insert(activity);
+
+        refresh_search_results();
     }
 
     void activity_list::edit_at_index(activity_index_t index, const activity &new_activity) {
-        if (*_data[index] == new_activity) {
+        if ((*this)[index] == new_activity) {
             return;
         }
 
@@ -66,13 +88,7 @@ namespace stg {
     }
 
     auto activity_list::has(const activity &searched_activity) const -> bool {
-        for (const auto &activity : _data) {
-            if (*activity == searched_activity) {
-                return true;
-            }
-        }
-
-        return false;
+        return index_of(searched_activity).has_value();
     }
 
     void activity_list::silently_drag(activity_index_t from_index, activity_index_t to_index) {
@@ -88,6 +104,9 @@ namespace stg {
             std::rotate(_data.begin() + from_index,
                         _data.begin() + from_index + 1,
                         _data.begin() + to_index + 1);
+
+        update_indices(std::min(from_index, to_index));
+        rehash();
     }
 
     void activity_list::drag(activity_index_t from_index, activity_index_t to_index) {
@@ -101,53 +120,60 @@ namespace stg {
     }
 
     activity_list::activity_list(const std::vector<activity> &from_vector) {
-        std::transform(from_vector.begin(),
-                       from_vector.end(),
-                       std::back_inserter(_data),
-                       [](auto &activity) {
-                           return std::make_shared<stg::activity>(activity);
-                       });
+        for (const auto &activity : from_vector) {
+            auto id = take_place(activity);
+            _data.push_back(id);
 
-        if (!search_query.empty())
-            search(search_query);
-    }
+            search_index.insert(get(id));
+        }
 
-    activity_list::activity_list(const data_t &from_vector) {
-        _data = from_vector;
+        update_indices();
+        rehash();
+    }
 
-        if (!search_query.empty())
-            search(search_query);
+    activity_list::activity_list(const snapshot_t &snapshot) {
+        reset_with(snapshot);
     }
 
     auto activity_list::operator[](activity_index_t item_index) const -> const activity & {
-        return *_data[item_index];
+        return *get(_data[item_index]);
     }
 
     auto activity_list::at(activity_index_t item_index) const -> stg::activity * {
-        return _data.at(item_index).get();
+        return get(_data.at(item_index));
+    }
+
+    auto activity_list::id_at(activity_index_t item_index) const -> activity_id {
+        return _data.at(item_index);
     }
 
-    auto activity_list::index_of(const activity *activity) const -> std::optional<index_t> {
-        auto it = std::find_if(_data.begin(), _data.end(), [=](auto &a) {
-            return a.get() == activity;
-        });
+    auto activity_list::get(activity_id id) const -> stg::activity * {
+        const auto *place = place_for(id);
+        if (!place) {
+            return nullptr;
+        }
+
+        // Activities are only changed through the list, which is what strategy does.
+        return const_cast<stg::activity *>(&*place->activity);
+    }
 
-        if (it == _data.end()) {
+    auto activity_list::index_of(activity_id id) const -> std::optional<index_t> {
+        const auto *place = place_for(id);
+        if (!place) {
             return std::nullopt;
         }
 
-        return std::distance(_data.begin(), it);
+        return place->index;
     }
 
     auto activity_list::index_of(const activity &activity) const -> std::optional<index_t> {
-        auto it = std::find_if(_data.begin(), _data.end(),
-                               [&](auto &a) { return *a == activity; });
-
-        if (it == _data.end()) {
-            return std::nullopt;
+        for (auto index = 0; index < size(); index++) {
+            if ((*this)[index] == activity) {
+                return index;
+            }
         }
 
-        return std::distance(_data.begin(), it);
+        return std::nullopt;
     }
 
     auto activity_list::search(std::string query) const -> bool {
@@ -159,27 +185,73 @@ namespace stg {
         if (query.empty()) {
             auto was_updated = !search_results.empty() || !old_query.empty();
             search_results.clear();
+            folded_search_query.clear();
 
             return was_updated;
         }
 
-        query = string::utf8_fold_case(query);
+        auto folded_query = string::utf8_fold_case(query);
 
-        data_t results;
-        std::for_each(begin(), end(), [&query, &results](auto &activity) {
-            auto name = string::utf8_fold_case(activity->name());
+        // Names matching the extended query always match the previous one.
+        auto extends_previous_query = !old_query.empty() &&
+                                      folded_query.find(folded_search_query) != std::string::npos;
 
-            if (name.find(query) != std::string::npos)
-                results.push_back(activity);
-        });
+        auto results = find_matching(folded_query, extends_previous_query);
 
         auto was_updated = old_query.empty() || search_results != results;
 
-        search_results = results;
+        folded_search_query = std::move(folded_query);
+        search_results = std::move(results);
 
         return was_updated;
     }
 
+    auto activity_list::find_matching(const std::string &folded_query,
+                                      bool narrows_previous_results) const -> data_t {
+        using rank = activity_search_index::rank;
+
+        auto ranks = std::unordered_map<const activity *, rank>();
+
+        if (narrows_previous_results) {
+            for (auto id : search_results) {
+                const auto *activity = get(id);
+                if (auto rank = search_index.rank_of(activity, folded_query))
+                    ranks.emplace(activity, *rank);
+            }
+        } else {
+            for (const auto &match : search_index.search(folded_query))
+                ranks.emplace(match.activity, match.rank);
+        }
+
+        auto ranked_results = std::vector<std::pair<rank, data_t::value_type>>();
+        ranked_results.reserve(ranks.size());
+
+        for (auto it = _data.begin(); it != _data.end() && ranked_results.size() < ranks.size(); ++it) {
+            auto rank_it = ranks.find(get(*it));
+            if (rank_it != ranks.end())
+                ranked_results.emplace_back(rank_it->second, *it);
+        }
+
+        std::stable_sort(ranked_results.begin(),
+                         ranked_results.end(),
+                         [](auto &lhs, auto &rhs) { return lhs.first < rhs.first; });
+
+        data_t results;
+        results.reserve(ranked_results.size());
+
+        for (auto &[rank, id] : ranked_results)
+            results.push_back(id);
+
+        return results;
+    }
+
+    void activity_list::refresh_search_results() const {
+        if (search_query.empty())
+            return;
+
+        search_results = find_matching(folded_search_query, false);
+    }
+
     auto activity_list::filtered() const -> const data_t & {
         if (search_query.empty())
             return _data;
@@ -188,13 +260,12 @@ namespace stg {
     }
 
     auto activity_list::index_from_filtered(index_t index_in_filtered) const -> std::optional<index_t> {
-        auto *activity = filtered().at(index_in_filtered).get();
-        return index_of(activity);
+        return index_of(filtered().at(index_in_filtered));
     }
 
     auto activity_list::index_in_filtered(index_t activity_index) const -> std::optional<index_t> {
-        const auto &activity = _data[activity_index];
-        auto it = std::find(filtered().begin(), filtered().end(), activity);
+        auto id = _data[activity_index];
+        auto it = std::find(filtered().begin(), filtered().end(), id);
 
         if (it == filtered().end())
             return std::nullopt;
@@ -204,10 +275,165 @@ namespace stg {
 
 
     void activity_list::reset_with(data_t data) {
-        activity_list_base::reset_with(data);
+        auto kept_ids = std::unordered_set<activity_id>(data.begin(), data.end());
+
+        for (auto id : _data) {
+            if (!kept_ids.count(id)) {
+                search_index.erase(get(id));
+                free_place(id);
+            }
+        }
+
+        activity_list_base::reset_with(std::move(data));
+
+        update_indices();
+        rehash();
+
+        refresh_search_results();
+    }
+
+    void activity_list::reset_with(const snapshot_t &snapshot) {
+        auto restored_ids = std::unordered_set<activity_id>();
+        restored_ids.reserve(snapshot->size());
+
+        for (const auto &item : *snapshot) {
+            restored_ids.insert(item.id);
+        }
+
+        for (auto id : _data) {
+            if (!restored_ids.count(id)) {
+                search_index.erase(get(id));
+                free_place(id);
+            }
+        }
+
+        data_t data;
+        data.reserve(snapshot->size());
+
+        for (const auto &item : *snapshot) {
+            if (auto *activity = get(item.id)) {
+                if (*activity != item.activity) {
+                    search_index.erase(activity);
+                    *activity = item.activity;
+                    search_index.insert(activity);
+                }
+            } else {
+                take_place(item.id, item.activity);
+                search_index.insert(get(item.id));
+            }
+
+            data.push_back(item.id);
+        }
+
+        activity_list_base::reset_with(std::move(data));
+
+        update_indices();
+        rehash();
+
+        refresh_search_results();
+
+        last_snapshot = snapshot;
+        last_snapshot_version = _version;
+    }
+
+    auto activity_list::snapshot() const -> snapshot_t {
+        if (!last_snapshot || last_snapshot_version != _version) {
+            auto items = std::vector<snapshot_item>();
+            items.reserve(_data.size());
+
+            for (auto id : _data) {
+                items.push_back(snapshot_item{id, *get(id)});
+            }
+
+            last_snapshot = std::make_shared<const std::vector<snapshot_item>>(std::move(items));
+            last_snapshot_version = _version;
+        }
+
+        return last_snapshot;
+    }
+
+    void activity_list::update_indices(index_t from_index) {
+        for (auto index = from_index; index < size(); index++) {
+            places[_data[index].index].index = index;
+        }
+    }
+
+    auto activity_list::place_for(activity_id id) const -> const place * {
+        if (!id || id.index >= places.size()) {
+            return nullptr;
+        }
+
+        const auto &place = places[id.index];
+        if (place.generation != id.generation) {
+            return nullptr;
+        }
+
+        return &place;
+    }
+
+    auto activity_list::take_place(const activity &activity) -> activity_id {
+        auto index = static_cast<activity_id::index_t>(places.size());
+
+        while (!free_places.empty()) {
+            auto free_index = free_places.back();
+            free_places.pop_back();
+
+            if (places[free_index].generation == 0) {
+                index = free_index;
+                break;
+            }
+        }
+
+        if (index == places.size()) {
+            places.emplace_back();
+        }
+
+        auto id = activity_id(index, places[index].last_generation + 1);
+        take_place(id, activity);
+
+        return id;
+    }
+
+    void activity_list::take_place(activity_id id, const activity &activity) {
+        if (id.index >= places.size()) {
+            auto first_new_index = static_cast<activity_id::index_t>(places.size());
+            places.resize(id.index + 1);
+
+            for (auto index = first_new_index; index < id.index; index++) {
+                free_places.push_back(index);
+            }
+        }
+
+        auto &place = places[id.index];
+        place.activity.emplace(activity);
+        place.generation = id.generation;
+        place.last_generation = std::max(place.last_generation, id.generation);
+    }
+
+    void activity_list::free_place(activity_id id) {
+        auto &place = places[id.index];
+        place.activity.reset();
+        place.generation = 0;
+        place.index = -1;
+
+        free_places.push_back(id.index);
+    }
+
+    auto activity_list::version() const -> version_t {
+        return _version;
+    }
+
+    auto activity_list::content_hash() const -> content_hash_t {
+        return _content_hash;
+    }
+
+    void activity_list::rehash() {
+        _content_hash = 0;
+        for (auto i = size_t(0); i < _data.size(); i++) {
+            _content_hash += list_item_hash(i, (*this)[i].content_hash());
+        }
 
-        if (!search_query.empty())
-            search(search_query);
+        _version = ++last_version;
     }
 
     auto activity_list::already_present_exception::what() const noexcept -> const char * {
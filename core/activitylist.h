@@ -5,12 +5,16 @@
 #ifndef STRATEGR_ACTIVITYLIST_H
 #define STRATEGR_ACTIVITYLIST_H
 
+#include <deque>
 #include <functional>
 #include <memory>
 #include <optional>
+#include <string>
 #include <vector>
 
 #include "activity.h"
+#include "activityid.h"
+#include "activitysearchindex.h"
 #include "notifiableonchange.h"
 #include "privatelist.h"
 #include "streamablelist.h"
@@ -19,45 +23,129 @@ namespace stg {
     class strategy;
 
     using activity_index_t = unsigned int;
-    using activity_list_base = private_list<std::shared_ptr<activity>>;
+    using activity_list_base = private_list<activity_id>;
 
+    // Activities live in a slab, where every activity keeps its place for as long as it's in the list,
+    // so pointers to activities stay valid and editing an activity doesn't change its handle.
+    // The list itself only orders the handles.
     class activity_list : public activity_list_base,
                           public notifiable_on_change,
                           public streamable_list<activity_list> {
     public:
         class already_present_exception;
-        using const_iterator = std::vector<activity>::const_iterator;
+        using version_t = uint64_t;
+
+        struct snapshot_item {
+            activity_id id;
+            stg::activity activity;
+
+            friend auto operator==(const snapshot_item &lhs, const snapshot_item &rhs) -> bool {
+                return lhs.id == rhs.id && lhs.activity == rhs.activity;
+            }
+        };
+
+        // Copy of activities' values along with their handles, in list order.
+        // It's shared until the list changes.
+        using snapshot_t = std::shared_ptr<const std::vector<snapshot_item>>;
 
         explicit activity_list(const std::vector<activity> &from_vector = {});
-        explicit activity_list(const data_t &from_vector);
+
+        // Activities keep the handles they have in the snapshot.
+        explicit activity_list(const snapshot_t &snapshot);
 
         auto operator[](activity_index_t item_index) const -> const activity &;
         auto at(activity_index_t item_index) const -> activity *;
+        auto id_at(activity_index_t item_index) const -> activity_id;
+
+        // Returns nullptr if the activity isn't in the list anymore.
+        // Takes constant time.
+        auto get(activity_id id) const -> activity *;
 
-        auto index_of(const activity *activity) const -> std::optional<index_t>;
+        // Takes constant time.
+        auto index_of(activity_id id) const -> std::optional<index_t>;
         auto index_of(const activity &activity) const -> std::optional<index_t>;
 
+        // Results are ranked: prefix matches go first, then word-start matches,
+        // then substring and subsequence matches. Equally ranked results keep list order.
+        // When the query extends the previous one, only the previous results are searched.
         auto search(std::string query) const -> bool;
         auto filtered() const -> const data_t &;
         auto index_from_filtered(index_t index_in_filtered) const -> std::optional<index_t>;
         auto index_in_filtered(index_t activity_index) const -> std::optional<index_t>;
 
+        // Handles must belong to the list.
+        // Activities which handles aren't present anymore are removed.
         void reset_with(data_t data) override;
 
+        // Restores activities' values in their places,
+        // so time slots referring to the snapshot's handles stay valid.
+        void reset_with(const snapshot_t &snapshot);
+
+        auto snapshot() const -> snapshot_t;
+
+        // Version changes with every modification of the list.
+        auto version() const -> version_t;
+
+        // Order-aware hash of activities' contents.
+        auto content_hash() const -> content_hash_t;
+
         auto class_print_name() const -> std::string override;
 
     private:
         friend strategy;
 
+        struct place {
+            std::optional<stg::activity> activity = std::nullopt;
+
+            // Zero if the place is free.
+            activity_id::generation_t generation = 0;
+            activity_id::generation_t last_generation = 0;
+
+            // Index of the activity in the list.
+            index_t index = -1;
+        };
+
+        // Places are never moved, since std::deque doesn't relocate elements when it grows.
+        std::deque<place> places;
+
+        // Might contain places that have been taken again by reset_with(),
+        // these are skipped when a new place is needed.
+        std::vector<activity_id::index_t> free_places;
+
         mutable std::string search_query;
+        mutable std::string folded_search_query;
         mutable data_t search_results;
 
+        activity_search_index search_index;
+
+        mutable snapshot_t last_snapshot = nullptr;
+        mutable version_t last_snapshot_version = 0;
+
+        static inline version_t last_version = 0;
+
+        version_t _version = 0;
+        content_hash_t _content_hash = 0;
+
+        void rehash();
+
+        auto place_for(activity_id id) const -> const place *;
+        auto take_place(const activity &activity) -> activity_id;
+        void take_place(activity_id id, const activity &activity);
+        void free_place(activity_id id);
+
+        // Updates indices of activities starting with the given index.
+        void update_indices(index_t from_index = 0);
+
+        auto find_matching(const std::string &folded_query, bool narrows_previous_results) const -> data_t;
+        void refresh_search_results() const;
+
         void silently_add(const activity &activity) noexcept(false);
         void add(const activity &activity) noexcept(false);
 
         void silently_remove_at_index(activity_index_t index);
         void remove_at_index(activity_index_t index);
 
+        // The activity is changed in place and keeps its handle.
         void silently_edit_at_index(activity_index_t index, const activity &new_activity) noexcept(false);
         void edit_at_index(activity_index_t index, const activity &new_activity) noexcept(false);
 
@@ -0,0 +1,120 @@
+#include <algorithm>
+
+#include "activityruns.h"
+
+namespace stg {
+    activity_runs::activity_runs(const std::vector<time_slot> &time_slots) {
+        if (!time_slots.empty())
+            assign(time_slots, 0, static_cast<index_t>(time_slots.size()) - 1);
+    }
+
+    auto activity_runs::data() const -> const std::vector<run> & {
+        return runs;
+    }
+
+    void activity_runs::assign(const std::vector<time_slot> &time_slots,
+                               index_t first_index,
+                               index_t last_index) {
+        auto window_begin_time = time_slots[first_index].begin_time;
+        auto window_end_time = time_slots[last_index].end_time();
+
+        auto result = std::vector<run>();
+        result.reserve(runs.size() + last_index - first_index + 1);
+
+        for (const auto &run : runs) {
+            if (run.begin_time >= window_begin_time)
+                break;
+
+            push_merging(result, {run.activity,
+                                  run.begin_time,
+                                  std::min(run.end_time, window_begin_time)});
+        }
+
+        for (auto slot_index = first_index; slot_index <= last_index; slot_index++) {
+            const auto &slot = time_slots[slot_index];
+            push_merging(result, {slot.activity, slot.begin_time, slot.end_time()});
+        }
+
+        for (const auto &run : runs) {
+            if (run.end_time <= window_end_time)
+                continue;
+
+            push_merging(result, {run.activity,
+                                  std::max(run.begin_time, window_end_time),
+                                  run.end_time});
+        }
+
+        runs = std::move(result);
+    }
+
+    auto activity_runs::replace_activity(activity_id old_activity, activity_id new_activity) -> bool {
+        auto has_replaced = false;
+
+        auto result = std::vector<run>();
+        result.reserve(runs.size());
+
+        for (auto run : runs) {
+            if (run.activity == old_activity) {
+                run.activity = new_activity;
+                has_replaced = true;
+            }
+
+            push_merging(result, run);
+        }
+
+        runs = std::move(result);
+
+        return has_replaced;
+    }
+
+    void activity_runs::project(std::vector<time_slot> &time_slots) const {
+        auto first_run_index = size_t(0);
+
+        for (auto &slot : time_slots) {
+            auto slot_end_time = slot.end_time();
+
+            while (first_run_index < runs.size() &&
+                   runs[first_run_index].end_time <= slot.begin_time) {
+                first_run_index++;
+            }
+
+            activity_id longest_activity = time_slot::no_activity;
+            minutes longest_overlap = 0;
+            minutes covered_time = 0;
+
+            for (auto run_index = first_run_index;
+                 run_index < runs.size() && runs[run_index].begin_time < slot_end_time;
+                 run_index++) {
+                const auto &run = runs[run_index];
+                auto overlap = std::min(slot_end_time, run.end_time) - std::max(slot.begin_time, run.begin_time);
+
+                covered_time += overlap;
+
+                if (overlap > longest_overlap) {
+                    longest_activity = run.activity;
+                    longest_overlap = overlap;
+                }
+            }
+
+            auto empty_time = slot.duration - covered_time;
+
+            slot.activity = longest_overlap >= empty_time
+                                ? longest_activity
+                                : time_slot::no_activity;
+        }
+    }
+
+    void activity_runs::push_merging(std::vector<run> &runs, const run &run) {
+        if (run.activity == time_slot::no_activity || run.begin_time >= run.end_time)
+            return;
+
+        if (!runs.empty() &&
+            runs.back().activity == run.activity &&
+            runs.back().end_time == run.begin_time) {
+            runs.back().end_time = run.end_time;
+            return;
+        }
+
+        runs.push_back(run);
+    }
+}
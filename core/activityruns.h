@@ -0,0 +1,55 @@
+#ifndef STRATEGR_ACTIVITYRUNS_H
+#define STRATEGR_ACTIVITYRUNS_H
+
+#include <vector>
+
+#include "timeslot.h"
+
+namespace stg {
+    // Activities of a strategy as runs in absolute minutes, independent of the time slots grid.
+    // Time slots are projected from the runs, so changing slot duration, begin or end time
+    // back and forth doesn't lose or shift activities.
+    class activity_runs {
+    public:
+        using minutes = time_slot::minutes;
+        using index_t = int;
+
+        // Runs are sorted, don't overlap, and adjacent runs have different activities.
+        // There are no runs for empty time.
+        struct run {
+            activity_id activity = time_slot::no_activity;
+            minutes begin_time = 0;
+            minutes end_time = 0;
+
+            friend auto operator==(const run &lhs, const run &rhs) -> bool {
+                return lhs.activity == rhs.activity &&
+                       lhs.begin_time == rhs.begin_time &&
+                       lhs.end_time == rhs.end_time;
+            }
+        };
+
+        activity_runs() = default;
+        explicit activity_runs(const std::vector<time_slot> &time_slots);
+
+        auto data() const -> const std::vector<run> &;
+
+        // Replaces runs in the time window of the given slots with slots' activities.
+        // Both indices are inclusive.
+        void assign(const std::vector<time_slot> &time_slots, index_t first_index, index_t last_index);
+
+        // Returns true if there were runs of the old activity.
+        auto replace_activity(activity_id old_activity, activity_id new_activity) -> bool;
+
+        // Sets activity of every slot to the one that covers most of its time,
+        // preferring earlier activities, and activities over empty time.
+        // Slots must be sorted by begin time.
+        void project(std::vector<time_slot> &time_slots) const;
+
+    private:
+        std::vector<run> runs;
+
+        static void push_merging(std::vector<run> &runs, const run &run);
+    };
+}
+
+#endif//STRATEGR_ACTIVITYRUNS_H
@@ -0,0 +1,278 @@
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+#include "activitysearchindex.h"
+#include "stgstring.h"
+
+namespace stg {
+    namespace {
+        auto code_point_length(char lead_byte) -> size_t {
+            auto byte = static_cast<unsigned char>(lead_byte);
+
+            if (byte < 0x80)
+                return 1;
+            if ((byte >> 5) == 0x6)
+                return 2;
+            if ((byte >> 4) == 0xe)
+                return 3;
+            if ((byte >> 3) == 0x1e)
+                return 4;
+
+            return 1;
+        }
+
+        auto is_word_boundary(char byte) -> bool {
+            auto character = static_cast<unsigned char>(byte);
+            return character < 0x80 && (std::isspace(character) || std::ispunct(character));
+        }
+    }
+
+#pragma mark - Maintaining Index
+
+    void activity_search_index::insert(const activity *activity) {
+        if (ids.count(activity))
+            return;
+
+        entry_id id;
+        if (!free_ids.empty()) {
+            id = free_ids.back();
+            free_ids.pop_back();
+        } else {
+            id = static_cast<entry_id>(entries.size());
+            entries.emplace_back();
+        }
+
+        auto &entry = entries[id];
+        entry.activity = activity;
+        entry.folded_name = string::utf8_fold_case(activity->name());
+        entry.characters_mask = make_characters_mask(entry.folded_name);
+
+        for (auto trigram : make_trigrams(entry.folded_name)) {
+            auto &posting = postings[trigram];
+            posting.insert(std::lower_bound(posting.begin(), posting.end(), id), id);
+        }
+
+        ids.emplace(activity, id);
+    }
+
+    void activity_search_index::erase(const activity *activity) {
+        auto it = ids.find(activity);
+        if (it == ids.end())
+            return;
+
+        auto id = it->second;
+        auto &entry = entries[id];
+
+        for (auto trigram : make_trigrams(entry.folded_name)) {
+            auto posting_it = postings.find(trigram);
+            auto &posting = posting_it->second;
+
+            posting.erase(std::lower_bound(posting.begin(), posting.end(), id));
+
+            if (posting.empty())
+                postings.erase(posting_it);
+        }
+
+        entry = {};
+        free_ids.push_back(id);
+        ids.erase(it);
+    }
+
+    void activity_search_index::clear() {
+        entries.clear();
+        free_ids.clear();
+        ids.clear();
+        postings.clear();
+    }
+
+    auto activity_search_index::size() const -> size_t {
+        return ids.size();
+    }
+
+    auto activity_search_index::folded_name(const activity *activity) const -> const std::string & {
+        return entries[ids.at(activity)].folded_name;
+    }
+
+    auto activity_search_index::make_trigrams(const std::string &string) -> std::vector<trigram> {
+        if (string.size() < 3)
+            return {};
+
+        auto result = std::vector<trigram>();
+        result.reserve(string.size() - 2);
+
+        for (size_t i = 0; i + 2 < string.size(); i++) {
+            result.push_back(static_cast<trigram>(static_cast<unsigned char>(string[i])) << 16 |
+                             static_cast<trigram>(static_cast<unsigned char>(string[i + 1])) << 8 |
+                             static_cast<trigram>(static_cast<unsigned char>(string[i + 2])));
+        }
+
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+
+        return result;
+    }
+
+    auto activity_search_index::make_characters_mask(const std::string &string) -> uint64_t {
+        auto mask = uint64_t(0);
+        for (auto byte : string)
+            mask |= uint64_t(1) << (static_cast<unsigned char>(byte) & 63u);
+
+        return mask;
+    }
+
+#pragma mark - Searching
+
+    auto activity_search_index::search(const std::string &folded_query) const -> std::vector<match> {
+        if (folded_query.empty())
+            return {};
+
+        auto matches = std::vector<match>();
+        auto is_matched = std::vector<bool>(entries.size(), false);
+
+        for (auto id : substring_candidates(folded_query)) {
+            const auto &entry = entries[id];
+
+            if (auto rank = substring_rank(entry.folded_name, folded_query)) {
+                matches.push_back(match{entry.activity, *rank});
+                is_matched[id] = true;
+            }
+        }
+
+        // Single character can't match as a subsequence without being a substring.
+        if (code_point_length(folded_query.front()) == folded_query.size())
+            return matches;
+
+        auto query_mask = make_characters_mask(folded_query);
+
+        for (entry_id id = 0; id < entries.size(); id++) {
+            const auto &entry = entries[id];
+
+            if (!entry.activity || is_matched[id])
+                continue;
+
+            if (query_mask & ~entry.characters_mask)
+                continue;
+
+            if (auto rank = subsequence_rank(entry.folded_name, folded_query))
+                matches.push_back(match{entry.activity, *rank});
+        }
+
+        return matches;
+    }
+
+    auto activity_search_index::rank_of(const activity *activity,
+                                        const std::string &folded_query) const -> std::optional<rank> {
+        auto it = ids.find(activity);
+        if (it == ids.end())
+            return std::nullopt;
+
+        return rank_of(entries[it->second], folded_query, make_characters_mask(folded_query));
+    }
+
+    auto activity_search_index::rank_of(const entry &entry,
+                                        const std::string &query,
+                                        uint64_t query_mask) -> std::optional<rank> {
+        if (query_mask & ~entry.characters_mask)
+            return std::nullopt;
+
+        if (auto rank = substring_rank(entry.folded_name, query))
+            return rank;
+
+        return subsequence_rank(entry.folded_name, query);
+    }
+
+    auto activity_search_index::substring_candidates(const std::string &query) const -> std::vector<entry_id> {
+        auto all_ids = [this] {
+            auto result = std::vector<entry_id>();
+            result.reserve(ids.size());
+
+            for (entry_id id = 0; id < entries.size(); id++) {
+                if (entries[id].activity)
+                    result.push_back(id);
+            }
+
+            return result;
+        };
+
+        auto trigrams = make_trigrams(query);
+        if (trigrams.empty())
+            return all_ids();
+
+        auto lists = std::vector<const std::vector<entry_id> *>();
+        lists.reserve(trigrams.size());
+
+        for (auto trigram : trigrams) {
+            auto it = postings.find(trigram);
+            if (it == postings.end())
+                return {};
+
+            lists.push_back(&it->second);
+        }
+
+        std::sort(lists.begin(), lists.end(), [](auto *lhs, auto *rhs) {
+            return lhs->size() < rhs->size();
+        });
+
+        auto result = *lists.front();
+        auto intersection = std::vector<entry_id>();
+
+        for (auto it = std::next(lists.begin()); it != lists.end() && !result.empty(); ++it) {
+            intersection.clear();
+            std::set_intersection(result.begin(), result.end(),
+                                  (*it)->begin(), (*it)->end(),
+                                  std::back_inserter(intersection));
+
+            std::swap(result, intersection);
+        }
+
+        return result;
+    }
+
+    auto activity_search_index::substring_rank(const std::string &name,
+                                               const std::string &query) -> std::optional<rank> {
+        auto position = name.find(query);
+        if (position == std::string::npos)
+            return std::nullopt;
+
+        if (position == 0)
+            return rank{match_kind::prefix, name.size() - query.size()};
+
+        for (auto word_position = position;
+             word_position != std::string::npos;
+             word_position = name.find(query, word_position + 1)) {
+            if (is_word_boundary(name[word_position - 1]))
+                return rank{match_kind::word_start, word_position};
+        }
+
+        return rank{match_kind::substring, position};
+    }
+
+    auto activity_search_index::subsequence_rank(const std::string &name,
+                                                 const std::string &query) -> std::optional<rank> {
+        size_t query_position = 0;
+        size_t first_match_position = std::string::npos;
+        size_t name_position = 0;
+
+        while (name_position < name.size() && query_position < query.size()) {
+            auto name_length = code_point_length(name[name_position]);
+            auto query_length = code_point_length(query[query_position]);
+
+            if (name_length == query_length &&
+                name.compare(name_position, name_length, query, query_position, query_length) == 0) {
+                if (first_match_position == std::string::npos)
+                    first_match_position = name_position;
+
+                query_position += query_length;
+            }
+
+            name_position += name_length;
+        }
+
+        if (query_position < query.size())
+            return std::nullopt;
+
+        auto span = name_position - first_match_position;
+        return rank{match_kind::subsequence, span - query.size()};
+    }
+}
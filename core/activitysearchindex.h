@@ -0,0 +1,116 @@
+#ifndef STRATEGR_ACTIVITYSEARCHINDEX_H
+#define STRATEGR_ACTIVITYSEARCHINDEX_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "activity.h"
+
+namespace stg {
+    // Keeps case-folded activity names along with a trigram index over them.
+    // Substring matches are looked up in the index,
+    // subsequence matches are found by scanning names with a cheap character filter.
+    class activity_search_index {
+    public:
+        enum class match_kind {
+            prefix,
+            word_start,
+            substring,
+            subsequence
+        };
+
+        // Lower rank is a better match.
+        struct rank {
+            match_kind kind = match_kind::subsequence;
+            size_t distance = 0;
+
+            friend auto operator<(const rank &lhs, const rank &rhs) -> bool {
+                return std::tie(lhs.kind, lhs.distance) < std::tie(rhs.kind, rhs.distance);
+            }
+        };
+
+        struct match {
+            const activity *activity = nullptr;
+            struct rank rank;
+        };
+
+        void insert(const activity *activity);
+        void erase(const activity *activity);
+        void clear();
+
+        // Removes activities that aren't present in the given ones, and inserts new ones.
+        template<class Container>
+        void reset_with(const Container &activities);
+
+        auto size() const -> size_t;
+
+        auto folded_name(const activity *activity) const -> const std::string &;
+
+        // Query must be case-folded.
+        // Matches are unordered.
+        auto search(const std::string &folded_query) const -> std::vector<match>;
+        auto rank_of(const activity *activity, const std::string &folded_query) const -> std::optional<rank>;
+
+    private:
+        using entry_id = uint32_t;
+        using trigram = uint32_t;
+
+        struct entry {
+            const stg::activity *activity = nullptr;
+            std::string folded_name;
+            uint64_t characters_mask = 0;
+        };
+
+        std::vector<entry> entries;
+        std::vector<entry_id> free_ids;
+        std::unordered_map<const activity *, entry_id> ids;
+
+        // Sorted ids of entries containing a trigram.
+        std::unordered_map<trigram, std::vector<entry_id>> postings;
+
+        static auto make_trigrams(const std::string &string) -> std::vector<trigram>;
+        static auto make_characters_mask(const std::string &string) -> uint64_t;
+
+        static auto substring_rank(const std::string &name,
+                                   const std::string &query) -> std::optional<rank>;
+        static auto subsequence_rank(const std::string &name,
+                                     const std::string &query) -> std::optional<rank>;
+        static auto rank_of(const entry &entry,
+                            const std::string &query,
+                            uint64_t query_mask) -> std::optional<rank>;
+
+        auto substring_candidates(const std::string &query) const -> std::vector<entry_id>;
+    };
+
+    template<class Container>
+    void activity_search_index::reset_with(const Container &activities) {
+        auto present_ids = std::unordered_map<const activity *, entry_id>();
+        present_ids.reserve(activities.size());
+
+        for (const auto &activity : activities) {
+            auto it = ids.find(&*activity);
+            if (it != ids.end())
+                present_ids.insert(*it);
+        }
+
+        auto removed = std::vector<const activity *>();
+        for (auto &[activity, id] : ids) {
+            if (!present_ids.count(activity))
+                removed.push_back(activity);
+        }
+
+        for (auto *activity : removed)
+            erase(activity);
+
+        for (const auto &activity : activities) {
+            if (!present_ids.count(&*activity))
+                insert(&*activity);
+        }
+    }
+}
+
+#endif//STRATEGR_ACTIVITYSEARCHINDEX_H
@@ -91,7 +91,8 @@ NSString *const STGCalendarExporterKeyCalendarName = @"exportCalendarName";
 
 - (void)exportSession:(stg::session *)sessionPtr {
     auto &session = *sessionPtr;
-    if (!session.activity)
+    auto *activity = self->strategy->activities().get(session.activity);
+    if (!activity)
         return;
 
     NSDate *date = self.settings.date;
@@ -103,8 +104,8 @@ NSString *const STGCalendarExporterKeyCalendarName = @"exportCalendarName";
     NSString *calendarName = self.usingSpecificCalendar ? self.settings.calendarName : nil;
 
     if (!calendarName) {
-        calendarName = stg::to_nsstring(session.activity->name());
-        color = session.activity->color();
+        calendarName = stg::to_nsstring(activity->name());
+        color = activity->color();
     }
 
     EKCalendar *calendar = [self.calendarManager findOrCreateCalendarWithTitle:calendarName
@@ -112,7 +113,7 @@ NSString *const STGCalendarExporterKeyCalendarName = @"exportCalendarName";
 
     [self.calendarManager createEventForCalendar:calendar
                                             date:date
-                                           title:stg::to_nsstring(session.activity->name())
+                                           title:stg::to_nsstring(activity->name())
                                     beginMinutes:session.begin_time()
                                  durationMinutes:session.duration()
                             includeNotifications:includeNotifications];
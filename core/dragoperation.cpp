@@ -2,13 +2,20 @@
 // Created by Dmitry Khrykin on 2019-07-29.
 //
 
+#include <algorithm>
+#include <numeric>
+
 #include "dragoperation.h"
 #include "strategy.h"
 
 namespace stg {
-    drag_operation::drag_operation(time_slots_state *time_slots, indices_vector initial_indices)
-        : time_slots(time_slots),
+    drag_operation::drag_operation(const time_slots_state &time_slots,
+                                   time_slots_state &shadow_time_slots,
+                                   indices_vector initial_indices)
+        : initial_time_slots(time_slots.snapshot()),
+          time_slots(&shadow_time_slots),
           initial_dragged_indices(std::move(initial_indices)) {
+        shadow_time_slots.reset_with(initial_time_slots);
     }
 
     auto drag_operation::record_drag(const std::vector<time_slot> &time_slots_to_drag,
@@ -17,255 +24,147 @@ namespace stg {
             return {};
         }
 
+        if (initial_indices.empty()) {
+            initial_indices.resize(time_slots->size());
+            std::iota(initial_indices.begin(), initial_indices.end(), 0);
+        }
+
         auto range_to_drag = indices_range{*time_slots->index_of(time_slots_to_drag.front()),
                                            *time_slots->index_of(time_slots_to_drag.back())};
 
         // Drag operation_type is divided into two phases:
         // 1. Drag selected slots to their new positions, switching the nearby slots;
-        auto new_dragged_indices = silently_drag(range_to_drag, distance);
+        auto new_dragged_range = silently_drag(range_to_drag, distance);
+        if (!new_dragged_range) {
+            return {};
+        }
+
         // 2. Try to restore nearby sessions' initial positions.
-        validate_drag(new_dragged_indices);
+        restore_displaced_sessions(*new_dragged_range);
+
+        auto new_dragged_indices = indices_vector(new_dragged_range->size());
+        std::iota(new_dragged_indices.begin(), new_dragged_indices.end(), new_dragged_range->first);
 
         return new_dragged_indices;
     }
 
+    // Moves the range by the distance, shifting the slots in between
+    // to the opposite side, so it's a rotation of the affected slots.
     auto drag_operation::silently_drag(const indices_range &range_to_drag,
-                                       int distance) -> indices_vector {
+                                       int distance) -> std::optional<indices_range> {
         auto destination_index = distance < 0
                                      ? range_to_drag.first + distance
                                      : range_to_drag.last + distance;
 
-        if (destination_index > time_slots->size() - 1) {
-            return {};
+        if (destination_index < 0 || destination_index > time_slots->size() - 1) {
+            return std::nullopt;
         }
 
-        auto [cache_range, restore_cache_range, new_drag_range] = get_ranges(range_to_drag, destination_index, distance);
-
-        auto cache = make_cache(cache_range);
-
-        movements_state movements;
-        indices_vector new_dragged_indices;
-
-        for (auto i = 0; i < range_to_drag.size(); i++) {
-            auto insert_at_index = new_drag_range.first + i;
-            auto old_index = range_to_drag.first + i;
-
-            movements[old_index] = insert_at_index;
-
-            new_dragged_indices.push_back(insert_at_index);
-
-            auto activity_at_old_index = time_slots->at(old_index).activity;
-            time_slots->silently_set_activity_at_index(insert_at_index,
-                                                       activity_at_old_index);
+        if (distance < 0) {
+            rotate(destination_index, range_to_drag.first, range_to_drag.last + 1);
+        } else {
+            rotate(range_to_drag.first, range_to_drag.last + 1, destination_index + 1);
         }
 
-        restore_cache(restore_cache_range, cache, movements);
-
-        apply_movements_to_history(movements);
-
-        return new_dragged_indices;
+        return indices_range{range_to_drag.first + distance,
+                             range_to_drag.last + distance};
     }
 
-    void drag_operation::restore_cache(const indices_range &restore_cache_range,
-                                       const indices_cache &cache,
-                                       movements_state &movements) const {
-        for (size_t i = 0; i < cache.size(); i++) {
-            auto insert_at_index = static_cast<index_t>(restore_cache_range.first + i);
-            auto [history_index, activity] = cache[i];
-
-            movements[history_index] = insert_at_index;
-
-            time_slots->silently_set_activity_at_index(insert_at_index, activity);
+    void drag_operation::rotate(index_t first_index, index_t middle_index, index_t end_index) {
+        activities_buffer.clear();
+        for (auto i = first_index; i < end_index; i++) {
+            activities_buffer.push_back(time_slots->_data[i].activity);
         }
-    }
-
-    auto drag_operation::get_ranges(const indices_range &indices_to_drag,
-                                    index_t destination_index,
-                                    int distance) const -> ranges_tuple {
-        auto cache_range = get_cache_range(indices_to_drag,
-                                           destination_index,
-                                           distance);
-
-        auto restore_cache_first_index = distance < 0
-                                             ? destination_index + indices_to_drag.size()
-                                             : indices_to_drag.first;
-
-        auto restore_cache_range = indices_range{restore_cache_first_index,
-                                                 restore_cache_first_index + cache_range.size()};
-
-        auto new_drag_range = get_new_dragging_indices(indices_to_drag,
-                                                       destination_index,
-                                                       distance);
-
-        return std::make_tuple(cache_range, restore_cache_range, new_drag_range);
-    }
-
-    auto drag_operation::get_new_dragging_indices(const indices_range &dragging_indices,
-                                                  index_t destination_index,
-                                                  int distance) -> indices_range {
-        auto new_first_index = distance < 0
-                                   ? destination_index
-                                   : destination_index - dragging_indices.size() + 1;
-
-        return indices_range{new_first_index,
-                             new_first_index + dragging_indices.size()};
-    }
-
-    auto drag_operation::get_cache_range(const indices_range &dragging_indices,
-                                         index_t destination_index,
-                                         int distance) -> indices_range {
-        return distance < 0
-                   ? indices_range{destination_index,
-                                   dragging_indices.first - 1}
-                   : indices_range{dragging_indices.last + 1,
-                                   destination_index};
-    }
 
-    auto drag_operation::make_cache(indices_range cache_indices) const -> indices_cache {
-        indices_cache cache = {};
+        std::rotate(activities_buffer.begin(),
+                    activities_buffer.begin() + (middle_index - first_index),
+                    activities_buffer.end());
 
-        for (auto i = cache_indices.first; i <= cache_indices.last; i++) {
-            auto cache_entry = std::make_tuple(i, time_slots->at(i).activity);
-            cache.push_back(cache_entry);
+        for (auto i = first_index; i < end_index; i++) {
+            time_slots->set_slot_activity(i, activities_buffer[i - first_index]);
         }
 
-        return cache;
+        std::rotate(initial_indices.begin() + first_index,
+                    initial_indices.begin() + middle_index,
+                    initial_indices.begin() + end_index);
     }
 
-    void stg::drag_operation::validate_drag(const indices_vector &new_dragged_indices) {
-        if (new_dragged_indices.empty()) {
-            return;
-        }
-
-        auto nobody_can_move = false;
-
-        while (!nobody_can_move) {
-            auto cant_move_count = 0;
-
-            for (auto const &[current_index, past_indices] : history) {
-                auto slot_is_dragged = std::find(new_dragged_indices.begin(),
-                                                 new_dragged_indices.end(),
-                                                 current_index) != new_dragged_indices.end();
-
-                auto slot_is_empty = time_slots->at(current_index).activity == strategy::no_activity;
-
-                if (slot_is_dragged || slot_is_empty) {
-                    cant_move_count++;
-                    continue;
-                }
+    // Sessions are scanned top to bottom, and the first displaced session
+    // that can get closer to its initial position is moved there.
+    // Moving a session only affects the session right above it,
+    // so the scan resumes from there instead of starting over.
+    void drag_operation::restore_displaced_sessions(const indices_range &dragged_range) {
+        auto first_index = 0;
 
-                auto session_range = find_session_range_for(current_index);
+        while (first_index < time_slots->size()) {
+            auto session_range = session_range_at(first_index);
+            first_index = session_range.last + 1;
 
-                auto initial_session_begin_index = get_initial(session_range.first);
+            if (!is_displaced(session_range, dragged_range)) {
+                continue;
+            }
 
-                if (initial_session_begin_index != session_range.first) {
-                    auto can_move_to = find_avaliable_movement_index(session_range,
-                                                                     initial_session_begin_index);
+            auto initial_session_begin_index = initial_indices[session_range.first];
+            if (initial_session_begin_index == session_range.first) {
+                continue;
+            }
 
-                    if (can_move_to != session_range.first) {
-                        auto distance = can_move_to - session_range.first;
-                        silently_drag(session_range, distance);
-                        break;
-                    }
-                }
+            auto can_move_to = find_avaliable_movement_index(session_range,
+                                                             initial_session_begin_index);
 
-                cant_move_count++;
-            }
+            if (can_move_to != session_range.first) {
+                silently_drag(session_range, can_move_to - session_range.first);
 
-            if (cant_move_count == history.size()) {
-                nobody_can_move = true;
+                auto affected_first_index = std::min(session_range.first, can_move_to);
+                first_index = previous_session_first_index(affected_first_index);
             }
         }
     }
 
-    auto drag_operation::get_initial(index_t index) -> index_t {
-        return history.count(index)
-                   ? history[index][initial_index_key]
-                   : index;
-    }
-
-    void drag_operation::print_indices(const std::string &name,
-                                       const indices_vector &indices_state) {
-        std::cout << name << ": [ ";
-
-        for (auto index : indices_state) {
-            std::cout << index << " ";
+    auto drag_operation::is_displaced(const indices_range &session_range,
+                                      const indices_range &dragged_range) const -> bool {
+        if (time_slots->_data[session_range.first].activity == strategy::no_activity) {
+            return false;
         }
 
-        std::cout << "]" << std::endl;
-    }
-
-    void drag_operation::print_history(const std::string &name,
-                                       const history_state &history_state) {
-        std::cout << name << std::endl;
-        for (auto const &[current_index, past_indices] : history_state) {
-            if (!past_indices.empty()) {
-                print_indices(std::to_string(current_index), past_indices);
+        for (auto i = session_range.first; i <= session_range.last; i++) {
+            if (initial_indices[i] != i && !dragged_range.contains(i)) {
+                return true;
             }
         }
-    }
 
-    void drag_operation::print_movements(const movements_state &movements) {
-        std::cout << "movements:" << std::endl;
-        for (auto const &[past_index, current_index] : movements) {
-            std::cout << past_index << " -> " << current_index << std::endl;
-        }
+        return false;
     }
 
-    void drag_operation::apply_movements_to_history(const movements_state &movements) {
-        history_state new_history_stacks;
+    auto drag_operation::session_range_at(index_t first_index) -> indices_range {
+        auto activity = time_slots->at(first_index).activity;
 
-        for (auto const &[past_index, current_index] : movements) {
-            auto new_history_stack = history[past_index];
-            new_history_stack.push_back(past_index);
-
-            new_history_stacks[current_index] = new_history_stack;
+        auto last_index = first_index;
+        while (last_index + 1 < time_slots->size() &&
+               time_slots->at(last_index + 1).activity == activity) {
+            last_index++;
         }
 
-        for (auto const &[index, stack] : new_history_stacks) {
-            if (index == stack.front()) {
-                history.erase(index);
-            } else {
-                indices_vector history_entry{stack.front()};
-
-                // history entry doesn't need more than two values:
-                // only initial index and previous index if they're different
-                if (stack.back() != stack.front()) {
-                    history_entry.push_back(stack.back());
-                }
-
-                history[index] = history_entry;
-            }
-        }
+        return indices_range{first_index, last_index};
     }
 
-    auto drag_operation::find_session_range_for(index_t time_slot_index) -> indices_range {
-        if (time_slot_index < 0)
-            time_slot_index = 0;
-        if (time_slot_index > time_slots->size() - 1) {
-            time_slot_index = time_slots->size() - 1;
+    // Returns the first index of the closest non-empty session above the index.
+    auto drag_operation::previous_session_first_index(index_t index) -> index_t {
+        auto i = index - 1;
+        while (i >= 0 && time_slots->at(i).activity == strategy::no_activity) {
+            i--;
         }
 
-        auto begin_index = time_slot_index;
-        auto end_index = time_slot_index;
-
-        for (auto i = time_slot_index; i > 0; i--) {
-            if (time_slots->at(i).activity == time_slots->at(time_slot_index).activity) {
-                begin_index = i;
-            } else {
-                break;
-            }
+        if (i < 0) {
+            return 0;
         }
 
-        for (auto i = time_slot_index; i < time_slots->size(); i++) {
-            if (time_slots->at(i).activity == time_slots->at(time_slot_index).activity) {
-                end_index = i;
-            } else {
-                break;
-            }
+        auto activity = time_slots->at(i).activity;
+        while (i > 0 && time_slots->at(i - 1).activity == activity) {
+            i--;
         }
 
-        return indices_range{begin_index, end_index};
+        return i;
     }
 
     auto drag_operation::find_avaliable_movement_index(indices_range session_range,
@@ -310,19 +209,22 @@ namespace stg {
     }
 
     auto drag_operation::state_changed() -> bool {
-        return time_slots->data() != initial_time_slots;
+        return time_slots->differs_from(initial_time_slots);
     }
 
-    auto drag_operation::initial_state() -> time_slots_state::data_t & {
+    auto drag_operation::initial_state() const -> const time_slots_snapshot & {
         return initial_time_slots;
     }
 
-    drag_operation::indices_range::indices_range(index_t frst, index_t lst) {
-        first = frst < 0 ? 0 : frst;
-        last = lst < 0 ? 0 : lst;
+    auto drag_operation::preview() const -> const time_slots_state & {
+        return *time_slots;
     }
 
     auto drag_operation::indices_range::size() const -> index_t {
         return last - first + 1;
     }
-}
\ No newline at end of file
+
+    auto drag_operation::indices_range::contains(index_t index) const -> bool {
+        return index >= first && index <= last;
+    }
+}
@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+#include "instrumentation.h"
+
+namespace stg {
+
+#pragma mark - Measuring Sections
+
+    instrumentation::scope::scope(const char *name) {
+        if (!is_enabled())
+            return;
+
+        this->name = name;
+        start_time = clock::now();
+    }
+
+    instrumentation::scope::~scope() {
+        if (!name)
+            return;
+
+        auto duration = std::chrono::duration<milliseconds, std::milli>(clock::now() - start_time);
+        record(name, duration.count());
+    }
+
+    void instrumentation::set_enabled(bool is_enabled) {
+        enabled = is_enabled;
+    }
+
+    auto instrumentation::is_enabled() -> bool {
+        return enabled;
+    }
+
+    void instrumentation::record(const char *name, milliseconds duration) {
+        if (!is_enabled())
+            return;
+
+        auto lock = std::lock_guard(mutex);
+        windows[name].push(duration);
+    }
+
+#pragma mark - Reporting
+
+    auto instrumentation::summaries() -> std::vector<summary> {
+        auto lock = std::lock_guard(mutex);
+
+        auto result = std::vector<summary>();
+        result.reserve(windows.size());
+
+        for (auto &[name, window] : windows)
+            result.push_back(window.make_summary(name));
+
+        std::sort(result.begin(), result.end(),
+                  [](auto &lhs, auto &rhs) { return lhs.name < rhs.name; });
+
+        return result;
+    }
+
+    void instrumentation::reset() {
+        auto lock = std::lock_guard(mutex);
+        windows.clear();
+    }
+
+    void instrumentation::write_to_file(const std::string &path) noexcept(false) {
+        auto file = std::ofstream(path);
+        if (!file.is_open())
+            throw file_write_exception();
+
+        file << "section\tsamples\tp50_ms\tp99_ms\tmax_ms\n";
+
+        for (auto &summary : summaries()) {
+            file << summary.name << "\t"
+                 << summary.samples_count << "\t"
+                 << summary.p50 << "\t"
+                 << summary.p99 << "\t"
+                 << summary.max << "\n";
+        }
+
+        if (file.fail())
+            throw file_write_exception();
+    }
+
+#pragma mark - Samples Window
+
+    void instrumentation::samples_window::push(milliseconds duration) {
+        samples[next_index] = duration;
+        next_index = (next_index + 1) % window_size;
+        total_count++;
+    }
+
+    auto instrumentation::samples_window::make_summary(std::string_view name) const -> summary {
+        auto count = std::min(total_count, static_cast<size_t>(window_size));
+        auto sorted = std::vector<milliseconds>(samples.begin(), samples.begin() + count);
+        std::sort(sorted.begin(), sorted.end());
+
+        auto percentile = [&sorted](double fraction) -> milliseconds {
+            if (sorted.empty())
+                return 0;
+
+            auto index = static_cast<size_t>(std::ceil(fraction * sorted.size())) - 1;
+            return sorted[std::min(index, sorted.size() - 1)];
+        };
+
+        return summary{std::string(name),
+                       total_count,
+                       percentile(0.5),
+                       percentile(0.99),
+                       sorted.empty() ? 0 : sorted.back()};
+    }
+}
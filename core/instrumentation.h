@@ -0,0 +1,79 @@
+#ifndef STRATEGR_INSTRUMENTATION_H
+#define STRATEGR_INSTRUMENTATION_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace stg {
+    // Opt-in timing of named code sections.
+    // When disabled, measuring a section costs a single branch.
+    // Section names must be string literals, since they aren't copied.
+    class instrumentation {
+    public:
+        using milliseconds = double;
+
+        // Percentiles are calculated over the latest samples only.
+        static constexpr auto window_size = 256;
+
+        struct summary {
+            std::string name;
+            size_t samples_count = 0;
+            milliseconds p50 = 0;
+            milliseconds p99 = 0;
+            milliseconds max = 0;
+        };
+
+        struct file_write_exception : public std::exception {
+        };
+
+        class scope {
+        public:
+            explicit scope(const char *name);
+            ~scope();
+
+            scope(const scope &) = delete;
+            auto operator=(const scope &) -> scope & = delete;
+
+        private:
+            using clock = std::chrono::steady_clock;
+
+            const char *name = nullptr;
+            clock::time_point start_time;
+        };
+
+        static void set_enabled(bool enabled);
+        static auto is_enabled() -> bool;
+
+        static void record(const char *name, milliseconds duration);
+
+        // Sorted by section name.
+        static auto summaries() -> std::vector<summary>;
+        static void reset();
+
+        static void write_to_file(const std::string &path) noexcept(false);
+
+    private:
+        struct samples_window {
+            std::array<milliseconds, window_size> samples{};
+            size_t next_index = 0;
+            size_t total_count = 0;
+
+            void push(milliseconds duration);
+            auto make_summary(std::string_view name) const -> summary;
+        };
+
+        static inline std::atomic<bool> enabled{false};
+
+        static inline std::mutex mutex;
+        static inline std::unordered_map<std::string_view, samples_window> windows = {};
+    };
+}
+
+#endif//STRATEGR_INSTRUMENTATION_H
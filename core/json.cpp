@@ -19,8 +19,8 @@ namespace stg {
         std::transform(strategy.activities().begin(),
                        strategy.activities().end(),
                        std::back_inserter(json[keys::activities]),
-                       [](auto activity) {
-                           return activity->to_json();
+                       [&strategy](auto id) {
+                           return strategy.activities().get(id)->to_json();
                        });
 
         std::transform(strategy.time_slots().begin(),
@@ -44,10 +44,10 @@ namespace stg {
         try {
             auto json = nlohmann::json::parse(json_string);
 
-            auto activities = parse_activities(json);
+            auto activities = activity_list(parse_activities(json));
             auto time_slots = parse_time_slots(json, activities);
 
-            return std::make_unique<strategy>(time_slots, activities);
+            return std::make_unique<strategy>(time_slots, activities.snapshot());
         } catch (const std::exception &exception) {
             std::cerr << "Error while reading strategy from JSON: " << exception.what() << "\n";
             std::cerr << "JSON input was: \"" << json_string << "\"\n";
@@ -57,7 +57,7 @@ namespace stg {
     }
 
     auto json::parse_time_slots(const nlohmann::json &json,
-                                const activity_list::data_t &activities) -> time_slots_state::data_t {
+                                const activity_list &activities) -> time_slots_state::data_t {
         time_slots_state::data_t time_slots_vector;
 
         auto time_slot_duration = strategy::defaults::time_slot_duration;
@@ -81,8 +81,7 @@ namespace stg {
                     auto activity_index = static_cast<activity_list::index_t>(*it);
 
                     try {
-                        auto *activity = activities.at(activity_index).get();
-                        time_slot.activity = activity;
+                        time_slot.activity = activities.id_at(activity_index);
                     } catch (const std::out_of_range &) {
                         // activity is present in time slots, but not present in
                         // strategy.activities(), so we won't preserve it.
@@ -96,13 +95,12 @@ namespace stg {
         return time_slots_vector;
     }
 
-    auto json::parse_activities(const nlohmann::json &json) -> activity_list::data_t {
-        activity_list::data_t activities;
+    auto json::parse_activities(const nlohmann::json &json) -> std::vector<activity> {
+        std::vector<activity> activities;
 
         if (!json[keys::activities].is_null()) {
             for (const auto &activity_json : json[keys::activities]) {
-                auto activity = std::make_shared<stg::activity>(activity::from_json(activity_json));
-                activities.emplace_back(activity);
+                activities.emplace_back(activity::from_json(activity_json));
             }
         }
 
@@ -30,9 +30,9 @@ namespace stg {
     private:
         activity_list activities;
 
-        static auto parse_activities(const nlohmann::json &json) -> activity_list::data_t;
+        static auto parse_activities(const nlohmann::json &json) -> std::vector<activity>;
         static auto parse_time_slots(const nlohmann::json &json,
-                                     const activity_list::data_t &activities) -> time_slots_state::data_t;
+                                     const activity_list &activities) -> time_slots_state::data_t;
     };
 }
 
@@ -2,6 +2,8 @@
 // Created by Dmitry Khrykin on 2020-01-29.
 //
 
+#include <algorithm>
+
 #include "mousehandler.h"
 #include "actioncenter.h"
 #include "mousehandleroperations.h"
@@ -21,9 +23,14 @@ namespace stg {
         assert(get_slot_height != nullptr && "slot_height_getter must be provided");
     }
 
-    mouse_handler::~mouse_handler() = default;
+    mouse_handler::~mouse_handler() {
+        if (move_frame_timer)
+            move_frame_timer->invalidate();
+    }
 
     void mouse_handler::mouse_press(const mouse_event &event) {
+        flush_pending_move();
+
         current_slot_index = get_slot_index(event);
         current_session_index = get_session_index(current_slot_index);
         current_mouse_zone = get_mouse_zone(current_session_index, event.position);
@@ -49,6 +56,51 @@ namespace stg {
     }
 
     void mouse_handler::mouse_move(const mouse_event &event) {
+        _move_statistics.received_count++;
+
+        // While autoscrolling, moves are left to autoscroll frames,
+        // so that the model is updated at most once per frame.
+        if (!settings.coalesces_mouse_moves && !autoscroll_timer) {
+            process_mouse_move(event);
+            return;
+        }
+
+        if (pending_move) {
+            _move_statistics.coalesced_count++;
+            pending_move = event;
+            return;
+        }
+
+        pending_move = event;
+
+        if (autoscroll_timer)
+            return;
+
+        move_frame_timer = timer::schedule(settings.frame_duration, false, [this] {
+            // Timer has already fired, so there's nothing to invalidate.
+            move_frame_timer = nullptr;
+            flush_pending_move();
+        });
+    }
+
+    void mouse_handler::flush_pending_move() {
+        if (move_frame_timer) {
+            move_frame_timer->invalidate();
+            move_frame_timer = nullptr;
+        }
+
+        if (!pending_move)
+            return;
+
+        auto event = *pending_move;
+        pending_move = std::nullopt;
+
+        process_mouse_move(event);
+    }
+
+    void mouse_handler::process_mouse_move(const mouse_event &event) {
+        _move_statistics.processed_count++;
+
         current_slot_index = get_slot_index(event);
         current_session_index = get_session_index(current_slot_index);
         current_mouse_zone = get_mouse_zone(current_session_index, event.position);
@@ -65,6 +117,8 @@ namespace stg {
     }
 
     void mouse_handler::mouse_release(const mouse_event &event) {
+        flush_pending_move();
+
         current_operaion->stop(event);
         current_operaion = make_operation<none_operation>();
 
@@ -83,6 +137,8 @@ namespace stg {
     }
 
     void mouse_handler::key_down(const event &event) {
+        flush_pending_move();
+
         current_key_modifiers |= event.modifiers;
 
         if (current_operaion->type() == drag &&
@@ -99,6 +155,8 @@ namespace stg {
     }
 
     void mouse_handler::key_up(const event &event) {
+        flush_pending_move();
+
         current_key_modifiers |= event.modifiers;
 
         if (current_operaion->type() == copy_drag &&
@@ -115,8 +173,19 @@ namespace stg {
     }
 
     void mouse_handler::auto_scroll_frame(const point &new_mouse_position) {
+        // Pending move is superseded by the pointer position after scrolling.
+        if (move_frame_timer) {
+            move_frame_timer->invalidate();
+            move_frame_timer = nullptr;
+        }
+
+        if (pending_move) {
+            _move_statistics.coalesced_count++;
+            pending_move = std::nullopt;
+        }
+
         auto new_event = mouse_event(new_mouse_position, current_key_modifiers);
-        mouse_move(new_event);
+        process_mouse_move(new_event);
     }
 
     void mouse_handler::handle_autoscroll(const mouse_event &event) {
@@ -125,31 +194,37 @@ namespace stg {
         auto autoscroll_zone_size = settings.autoscroll_zone_size;
         auto pos_in_viewport = event.position - viewport.origin();
 
-        auto top_autoscroll_zone = range{0, autoscroll_zone_size};
         auto slotboard_height = (strategy.number_of_time_slots() + 1.0) * get_slot_height();
 
-        auto bottom_autoscroll_zone = range{viewport.height - autoscroll_zone_size,
-                                            viewport.height};
+        // Pointer might be outside of the viewport while the mouse is grabbed,
+        // so zones extend beyond viewport's edges.
+        auto top_depth = (autoscroll_zone_size - pos_in_viewport.y) / autoscroll_zone_size;
+        auto bottom_depth = (pos_in_viewport.y - viewport.height + autoscroll_zone_size) / autoscroll_zone_size;
 
-        auto needs_autoscroll_top = top_autoscroll_zone.contains(pos_in_viewport.y) &&
+        auto needs_autoscroll_top = top_depth >= 0 &&
                                     viewport.top > 0 &&
                                     event.position.y > 0;
 
-        auto needs_autoscroll_bottom = bottom_autoscroll_zone.contains(pos_in_viewport.y) &&
+        auto needs_autoscroll_bottom = bottom_depth >= 0 &&
                                        viewport.top + viewport.height < slotboard_height &&
                                        event.position.y < slotboard_height;
 
         auto needs_autoscroll = needs_autoscroll_top || needs_autoscroll_bottom;
 
-        if (!autoscroll_timer && needs_autoscroll) {
-            auto direction = scroll_direction::down;
-            if (needs_autoscroll_top) {
-                direction = scroll_direction::up;
-            } else if (needs_autoscroll_bottom) {
-                direction = scroll_direction::down;
-            }
+        if (needs_autoscroll) {
+            auto direction = needs_autoscroll_top
+                                 ? scroll_direction::up
+                                 : scroll_direction::down;
+
+            auto depth = std::min(needs_autoscroll_top ? top_depth : bottom_depth, (gfloat) 1);
 
-            start_autoscroll(direction);
+            autoscroll_velocity = settings.autoscroll_max_speed * std::max(depth, settings.autoscroll_min_depth);
+            if (direction == scroll_direction::up)
+                autoscroll_velocity = -autoscroll_velocity;
+        }
+
+        if (!autoscroll_timer && needs_autoscroll) {
+            start_autoscroll();
         } else if (autoscroll_timer && !needs_autoscroll) {
             stop_autoscroll();
         }
@@ -364,35 +439,51 @@ namespace stg {
         }
     }
 
-    void mouse_handler::start_autoscroll(scroll_direction direction) {
+    void mouse_handler::start_autoscroll() {
         if (!on_auto_scroll_frame)
             return;
 
-        double constexpr frame_seconds_duration = 1.0 / 30;
-        gfloat constexpr pixels_in_second = 200;
+        auto setup_auto_scroll_frame = [this] {
+            // The latest pointer position decides the speed of this frame,
+            // or stops autoscroll, in which case the pending move is already processed.
+            if (pending_move) {
+                handle_autoscroll(*pending_move);
+
+                if (!autoscroll_timer)
+                    return;
+            }
 
-        auto setup_auto_scroll_frame = [=] {
-            auto scroll_offset_increment = direction == mouse_handler::scroll_direction::down
-                                               ? pixels_in_second * frame_seconds_duration
-                                               : -pixels_in_second * frame_seconds_duration;
+            auto scroll_offset_increment = autoscroll_velocity * (gfloat) settings.frame_duration;
 
             auto mouse_position = on_auto_scroll_frame(scroll_offset_increment);
             auto_scroll_frame(mouse_position);
         };
 
-        autoscroll_timer = timer::schedule(frame_seconds_duration, true, setup_auto_scroll_frame);
+        autoscroll_timer = timer::schedule(settings.frame_duration, true, setup_auto_scroll_frame);
     }
 
     void mouse_handler::stop_autoscroll() {
         assert(autoscroll_timer.use_count() <= 1);
 
         autoscroll_timer = nullptr;
+        autoscroll_velocity = 0;
+
+        // Moves might have been left for the next autoscroll frame.
+        flush_pending_move();
     }
 
     auto mouse_handler::resize_boundary() const -> const resize_boundary_configuration & {
         return _resize_boundary;
     }
 
+    auto mouse_handler::move_statistics() const -> const mouse_move_statistics & {
+        return _move_statistics;
+    }
+
+    void mouse_handler::reset_move_statistics() {
+        _move_statistics = mouse_move_statistics();
+    }
+
     auto mouse_handler::context_actions() -> std::vector<const action *> {
         if (!action_center)
             return {};
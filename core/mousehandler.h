@@ -27,6 +27,16 @@ namespace stg {
         stg::gfloat stretch_zone_size = 5;
         stg::gfloat direction_change_resolution = 2;
         stg::gfloat autoscroll_zone_size = 40;
+
+        // Autoscroll speed is proportional to how deep the pointer is in the autoscroll zone,
+        // in pixels per second. Depth is in range from 0 to 1.
+        stg::gfloat autoscroll_max_speed = 600;
+        stg::gfloat autoscroll_min_depth = 0.1;
+
+        // When enabled, only the latest mouse move of every frame is processed.
+        // Autoscroll is also updated once per frame.
+        bool coalesces_mouse_moves = false;
+        double frame_duration = 1.0 / 60;
     };
 
     class mouse_handler {
@@ -62,6 +72,12 @@ namespace stg {
             index_t session_index = resize_boundary_configuration::none;
         };
 
+        struct mouse_move_statistics {
+            size_t received_count = 0;
+            size_t processed_count = 0;
+            size_t coalesced_count = 0;
+        };
+
         struct context_menu_configuration {
             point position;
             index_t slot_index;
@@ -97,6 +113,9 @@ namespace stg {
         void key_down(const event &event);
         void key_up(const event &event);
 
+        auto move_statistics() const -> const mouse_move_statistics &;
+        void reset_move_statistics();
+
     private:
         enum class mouse_zone {
             out_of_bounds,
@@ -144,6 +163,13 @@ namespace stg {
         std::unique_ptr<operation> current_operaion;
         std::shared_ptr<timer> autoscroll_timer = nullptr;
 
+        // Negative when scrolling up.
+        gfloat autoscroll_velocity = 0;
+
+        std::optional<mouse_event> pending_move = std::nullopt;
+        std::shared_ptr<timer> move_frame_timer = nullptr;
+        mouse_move_statistics _move_statistics;
+
         cursor current_cursor = cursor::pointer;
         mouse_zone current_mouse_zone = mouse_zone::out_of_bounds;
         direction current_direction = direction::none;
@@ -164,6 +190,12 @@ namespace stg {
 
         void handle_autoscroll(const stg::mouse_event &event);
 
+        void process_mouse_move(const mouse_event &event);
+
+        // Processes the pending coalesced move, if there's one,
+        // so that it isn't handled after the events that follow it.
+        void flush_pending_move();
+
         auto get_slot_index(const mouse_event &event) -> index_t;
         auto get_session_index(index_t slot_index) -> index_t;
         auto get_session_range(index_t session_index) -> range;
@@ -176,7 +208,7 @@ namespace stg {
         void update_cursor(event::key_modifiers modifiers);
         void update_direction(const mouse_event &event);
 
-        void start_autoscroll(scroll_direction direction);
+        void start_autoscroll();
         void stop_autoscroll();
         void auto_scroll_frame(const point &new_mouse_position);
 
@@ -227,7 +227,7 @@ private:
         if (new_local_distance < 0 && dragged_session_index == 0)
             return;
 
-        if (new_local_distance > 0 && dragged_session_index == strategy.sessions().size() - 1)
+        if (new_local_distance > 0 && dragged_session_index == strategy.drag_preview().size() - 1)
             return;
 
         global_distance = new_global_distance;
@@ -5,35 +5,159 @@
 #ifndef MODELS_NOTIFIABLEONCHANGE_H
 #define MODELS_NOTIFIABLEONCHANGE_H
 
+#include <algorithm>
 #include <functional>
 #include <optional>
+#include <vector>
+
+#include "stgsignal.h"
 
 namespace stg {
     class notifiable_on_change {
     public:
         using callback_t = std::function<void()>;
 
+        // In deferred mode, changes only mark the notifiable as dirty,
+        // and callbacks are invoked once on the next event loop turn,
+        // no matter how many changes happened before that.
+        // Deferred mode requires a post hook, otherwise callbacks are invoked immediately.
+        enum class dispatch_mode {
+            immediate,
+            deferred
+        };
+
+        struct dispatch_statistics {
+            size_t dispatched_callbacks_count = 0;
+            size_t suppressed_callbacks_count = 0;
+        };
+
+#pragma mark - Setting Up Deferred Dispatch
+
+        using post_hook_t = std::function<void(std::function<void()>)>;
+
+        // Post hook must run the given function on the next event loop turn.
+        static void set_post_hook(post_hook_t hook) {
+            post_hook = std::move(hook);
+        }
+
+        static auto statistics() -> const dispatch_statistics & {
+            return mutable_statistics();
+        }
+
+        static void reset_statistics() {
+            mutable_statistics() = dispatch_statistics();
+        }
+
+        // Invokes callbacks of all dirty notifiables right away.
+        static void flush_pending() {
+            flush_is_posted = false;
+
+            auto batch = std::move(pending);
+            pending.clear();
+
+            flushing_batch = &batch;
+
+            for (const auto *notifiable : batch) {
+                // Notifiable might have been destroyed by one of the previous callbacks.
+                if (!notifiable)
+                    continue;
+
+                notifiable->is_pending = false;
+                notifiable->dispatch_change_event();
+            }
+
+            flushing_batch = nullptr;
+        }
+
+#pragma mark - Construction
+
         notifiable_on_change() = default;
         notifiable_on_change(const notifiable_on_change &) = delete;
 
-        void add_on_change_callback(const callback_t &callback) const {
-            on_change_callbacks.push_back(callback);
+        virtual ~notifiable_on_change() {
+            if (!is_pending)
+                return;
+
+            pending.erase(std::remove(pending.begin(), pending.end(), this), pending.end());
+
+            if (flushing_batch)
+                std::replace(flushing_batch->begin(),
+                             flushing_batch->end(),
+                             static_cast<const notifiable_on_change *>(this),
+                             static_cast<const notifiable_on_change *>(nullptr));
+        }
+
+#pragma mark - Adding Callbacks
+
+        // Callback stays connected for the notifiable's lifetime,
+        // unless the returned connection is disconnected.
+        // Store it in a scoped_connection if the listener can die earlier.
+        auto add_on_change_callback(const callback_t &callback) const -> connection {
+            return on_change_signal.connect(callback);
         }
 
         template<class Listener, typename Method = std::function<void(Listener *)>>
-        void add_on_change_callback(Listener *listener, const Method &method) const {
-            add_on_change_callback(std::bind(method, listener));
+        auto add_on_change_callback(Listener *listener, const Method &method) const -> connection {
+            return add_on_change_callback(std::bind(method, listener));
+        }
+
+#pragma mark - Choosing Dispatch Mode
+
+        void set_dispatch_mode(dispatch_mode mode) const {
+            _dispatch_mode = mode;
+        }
+
+        auto get_dispatch_mode() const -> dispatch_mode {
+            return _dispatch_mode;
         }
 
     protected:
-        mutable std::vector<callback_t> on_change_callbacks = {};
+        signal<> on_change_signal;
 
         virtual void on_change_event() const {
-            for (const auto &callback : on_change_callbacks) {
-                callback();
+            if (_dispatch_mode == dispatch_mode::deferred && post_hook) {
+                mark_pending();
+                return;
+            }
+
+            dispatch_change_event();
+        }
+
+    private:
+        static inline post_hook_t post_hook = nullptr;
+
+        static inline std::vector<const notifiable_on_change *> pending = {};
+        static inline std::vector<const notifiable_on_change *> *flushing_batch = nullptr;
+        static inline bool flush_is_posted = false;
+
+        mutable dispatch_mode _dispatch_mode = dispatch_mode::immediate;
+        mutable bool is_pending = false;
+
+        static auto mutable_statistics() -> dispatch_statistics & {
+            static auto statistics = dispatch_statistics();
+            return statistics;
+        }
+
+        void dispatch_change_event() const {
+            mutable_statistics().dispatched_callbacks_count += on_change_signal.size();
+            on_change_signal();
+        }
+
+        void mark_pending() const {
+            if (is_pending) {
+                mutable_statistics().suppressed_callbacks_count += on_change_signal.size();
+                return;
+            }
+
+            is_pending = true;
+            pending.push_back(this);
+
+            if (!flush_is_posted) {
+                flush_is_posted = true;
+                post_hook([] { flush_pending(); });
             }
         }
     };
 };
 
-#endif//MODELS_NOTIFIABLEONCHANGE_H
\ No newline at end of file
+#endif//MODELS_NOTIFIABLEONCHANGE_H
@@ -0,0 +1,315 @@
+#include <chrono>
+#include <stdexcept>
+
+#include "activity.h"
+#include "activitylist.h"
+#include "notificationplanner.h"
+#include "notifier.h"
+#include "sessionslist.h"
+
+namespace stg {
+
+#pragma mark - Main Thread Dispatcher Backend
+
+    notification_planner::backend::dispatcher_t notification_planner::backend::dispatcher = nullptr;
+
+    void notification_planner::backend::set_main_thread_dispatcher(dispatcher_t fn) {
+        backend::dispatcher = std::move(fn);
+    }
+
+#pragma mark - Snapshots
+
+    auto notification_planner::session_snapshot::from(const session &session,
+                                                       const activity_list &activities) -> session_snapshot {
+        auto result = session_snapshot();
+        if (auto *activity = activities.get(session.activity))
+            result.activity_name = activity->name();
+
+        result.begin_time = session.begin_time();
+        result.end_time = session.end_time();
+
+        return result;
+    }
+
+    auto notification_planner::make_snapshot(const sessions_list &sessions,
+                                             const activity_list &activities) -> snapshot {
+        auto result = snapshot();
+        result.today_timestamp = time_utils::today_timestamp();
+        result.sessions.reserve(sessions.size());
+
+        for (const auto &session : sessions)
+            result.sessions.push_back(session_snapshot::from(session, activities));
+
+        return result;
+    }
+
+#pragma mark - Planning Notifications
+
+    static auto make_notification_title(const notification_planner::session_snapshot &session,
+                                        notification_type type) -> std::string {
+        if (type == notification_type::prepare_strategy_end ||
+            type == notification_type::strategy_end) {
+            return "End Of A Strategy";
+        }
+
+        if (!session.activity_name)
+            throw std::invalid_argument("session must have an activity for this type of notification");
+
+        auto duration = session.end_time - session.begin_time;
+        return *session.activity_name + " (" + time_utils::human_string_from_minutes(duration) + ")";
+    }
+
+    static auto make_notification_message(notification_type type) -> std::string {
+        const auto minutes_interval = notifier::prepare_seconds_interval / 60;
+        const auto time_string = time_utils::human_string_from_minutes(minutes_interval);
+
+        switch (type) {
+            case notification_type::prepare_start:
+                return "Coming up in " + time_string;
+            case notification_type::start:
+                return "Starts right now";
+            case notification_type::prepare_end:
+                return "Ends in " + time_string;
+            case notification_type::end:
+                return "Ends right now";
+            case notification_type::prepare_strategy_end:
+                return "Strategy ends in " + time_string;
+            case notification_type::strategy_end:
+                return "Strategy ends right now";
+            default:
+                return "";
+        }
+    }
+
+    static auto make_notification_delivery_time(const notification_planner::session_snapshot &session,
+                                                notification_type type,
+                                                time_t today_timestamp) -> time_t {
+        auto make_relative_time = [&]() -> notifier::seconds {
+            switch (type) {
+                case notification_type::prepare_start:
+                    return notifier::prepare_delivery_seconds(session.begin_time);
+                case notification_type::start:
+                    return notifier::immediate_delivery_seconds(session.begin_time);
+                case notification_type::prepare_end:
+                case notification_type::prepare_strategy_end:
+                    return notifier::prepare_delivery_seconds(session.end_time);
+                case notification_type::end:
+                case notification_type::strategy_end:
+                    return notifier::immediate_delivery_seconds(session.end_time);
+                default:
+                    return 0;
+            }
+        };
+
+        auto relative_time = make_relative_time();
+        auto day = notifier::seconds(24 * 60 * 60);
+
+        if (relative_time >= day) {
+            relative_time = relative_time - day;
+        }
+
+        return today_timestamp + relative_time;
+    }
+
+    auto notification_planner::make_notification(const session_snapshot &session,
+                                                 notification_type type,
+                                                 time_t today_timestamp) -> user_notifications::notification {
+        return user_notifications::notification(make_notification_title(session, type),
+                                                make_notification_message(type),
+                                                make_notification_delivery_time(session, type, today_timestamp),
+                                                std::make_shared<notification_type>(type));
+    }
+
+    auto notification_planner::make_plan(const snapshot &snapshot) -> notifications_list {
+        notifications_list notifications;
+
+        const auto &sessions = snapshot.sessions;
+        const auto today_timestamp = snapshot.today_timestamp;
+
+        for (auto session_it = sessions.begin(); session_it != sessions.end(); ++session_it) {
+            const auto &session = *session_it;
+            auto next_session_it = std::next(session_it);
+
+            if (session.activity_name) {
+                notifications.emplace_back(make_notification(session, notification_type::prepare_start, today_timestamp));
+                notifications.emplace_back(make_notification(session, notification_type::start, today_timestamp));
+
+                if (next_session_it != sessions.end() && !next_session_it->activity_name) {
+                    notifications.emplace_back(make_notification(session, notification_type::prepare_end, today_timestamp));
+                    notifications.emplace_back(make_notification(session, notification_type::end, today_timestamp));
+                }
+            }
+
+            if (next_session_it == sessions.end()) {
+                notifications.emplace_back(make_notification(session, notification_type::prepare_strategy_end, today_timestamp));
+                notifications.emplace_back(make_notification(session, notification_type::strategy_end, today_timestamp));
+            }
+        }
+
+        return notifications;
+    }
+
+#pragma mark - Getting Shared Instance
+
+    auto notification_planner::shared() -> notification_planner & {
+        static auto instance = notification_planner();
+        return instance;
+    }
+
+    notification_planner::~notification_planner() {
+        if (!worker.joinable())
+            return;
+
+        {
+            auto lock = std::lock_guard(wake_mutex);
+            is_stopping = true;
+        }
+
+        wake_condition.notify_all();
+        worker.join();
+    }
+
+#pragma mark - Registering Clients
+
+    void notification_planner::add_client(client_t client, plan_callback_t plan_callback) {
+        clients[client].plan_callback = std::move(plan_callback);
+    }
+
+    void notification_planner::remove_client(client_t client) {
+        // Plans that are still in flight are dropped on delivery.
+        clients.erase(client);
+    }
+
+#pragma mark - Requesting Plans
+
+    void notification_planner::enqueue(client_t client,
+                                       const sessions_list &sessions,
+                                       const activity_list &activities) {
+        if (!backend::dispatcher)
+            return plan_now(client, sessions, activities);
+
+        auto &state = clients[client];
+
+        auto client_snapshot = make_snapshot(sessions, activities);
+        client_snapshot.client = client;
+        client_snapshot.generation = state.generation = ++last_generation;
+
+        start_worker_if_needed();
+
+        if (!snapshots.try_push(std::move(client_snapshot))) {
+            // The worker is too far behind, so we plan right here instead.
+            return plan_now(client, sessions, activities);
+        }
+
+        enqueued_count++;
+
+        {
+            auto lock = std::lock_guard(wake_mutex);
+        }
+
+        wake_condition.notify_one();
+    }
+
+    void notification_planner::plan_now(client_t client,
+                                        const sessions_list &sessions,
+                                        const activity_list &activities) {
+        auto &state = clients[client];
+
+        auto client_snapshot = make_snapshot(sessions, activities);
+        client_snapshot.client = client;
+        client_snapshot.generation = state.generation = ++last_generation;
+
+        deliver(plan{client, client_snapshot.generation, make_plan(client_snapshot)});
+    }
+
+    auto notification_planner::has_pending_plan(client_t client) const -> bool {
+        auto client_it = clients.find(client);
+        if (client_it == clients.end())
+            return false;
+
+        return client_it->second.delivered_generation != client_it->second.generation;
+    }
+
+    void notification_planner::wait_until_idle() {
+        while (processed_count.load(std::memory_order_acquire) < enqueued_count) {
+            drain();
+            std::this_thread::yield();
+        }
+
+        drain();
+    }
+
+#pragma mark - Running Worker Thread
+
+    void notification_planner::start_worker_if_needed() {
+        if (worker.joinable())
+            return;
+
+        worker = std::thread([this] { run_worker(); });
+    }
+
+    void notification_planner::run_worker() {
+        while (true) {
+            {
+                auto lock = std::unique_lock(wake_mutex);
+                wake_condition.wait(lock, [this] {
+                    return is_stopping || !snapshots.empty();
+                });
+            }
+
+            if (is_stopping)
+                return;
+
+            // Only the latest snapshot of every client needs to be planned,
+            // the older ones are already outdated.
+            std::unordered_map<client_t, snapshot> latest_snapshots;
+            size_t popped_count = 0;
+
+            while (auto client_snapshot = snapshots.try_pop()) {
+                popped_count++;
+                latest_snapshots.insert_or_assign(client_snapshot->client, std::move(*client_snapshot));
+            }
+
+            for (auto &[client, client_snapshot] : latest_snapshots) {
+                auto client_plan = plan{client, client_snapshot.generation, make_plan(client_snapshot)};
+
+                while (!plans.try_push(std::move(client_plan))) {
+                    if (is_stopping)
+                        return;
+
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            }
+
+            processed_count.fetch_add(popped_count, std::memory_order_release);
+
+            if (backend::dispatcher)
+                backend::dispatcher([this] { drain(); });
+        }
+    }
+
+#pragma mark - Delivering Plans On Main Thread
+
+    void notification_planner::drain() {
+        while (auto client_plan = plans.try_pop()) {
+            deliver(std::move(*client_plan));
+        }
+    }
+
+    void notification_planner::deliver(plan plan) {
+        auto client_it = clients.find(plan.client);
+        if (client_it == clients.end())
+            return;
+
+        auto &state = client_it->second;
+
+        // A newer plan for this client is on its way.
+        if (plan.generation != state.generation)
+            return;
+
+        state.delivered_generation = plan.generation;
+
+        if (state.plan_callback)
+            state.plan_callback(std::move(plan.notifications));
+    }
+}
@@ -0,0 +1,170 @@
+#ifndef STRATEGR_NOTIFICATIONPLANNER_H
+#define STRATEGR_NOTIFICATIONPLANNER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <ctime>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "notifications.h"
+#include "session.h"
+#include "spscqueue.h"
+#include "time_utils.h"
+
+namespace stg {
+    class activity_list;
+    class sessions_list;
+
+#pragma mark - Notification Type
+
+    enum class notification_type {
+        prepare_start,
+        start,
+        prepare_end,
+        end,
+        prepare_strategy_end,
+        strategy_end
+    };
+
+#pragma mark - Notification Planner
+
+    // Builds notifications for immutable sessions snapshots on a worker thread,
+    // so that strategy changes don't block on string building.
+    //
+    // Planned notifications are handed back to clients on the main thread,
+    // which requires a main thread dispatcher backend.
+    // Without it, planning is performed synchronously.
+
+    class notification_planner {
+    public:
+#pragma mark - Type Aliases
+
+        using minutes = time_utils::minutes;
+        using client_t = const void *;
+        using notifications_list = std::vector<user_notifications::notification>;
+        using plan_callback_t = std::function<void(notifications_list)>;
+
+#pragma mark - Main Thread Dispatcher Backend
+
+        class backend {
+        public:
+            // Dispatcher must run the given function on the main thread,
+            // and must be safe to call from any thread.
+            using dispatcher_t = std::function<void(std::function<void()>)>;
+
+            static void set_main_thread_dispatcher(dispatcher_t fn);
+
+        private:
+            friend notification_planner;
+
+            static dispatcher_t dispatcher;
+        };
+
+#pragma mark - Snapshots
+
+        struct session_snapshot {
+            std::optional<std::string> activity_name;
+            minutes begin_time = 0;
+            minutes end_time = 0;
+
+            static auto from(const session &session,
+                             const activity_list &activities) -> session_snapshot;
+        };
+
+        struct snapshot {
+            client_t client = nullptr;
+            size_t generation = 0;
+            time_t today_timestamp = 0;
+            std::vector<session_snapshot> sessions;
+        };
+
+        static auto make_snapshot(const sessions_list &sessions,
+                                  const activity_list &activities) -> snapshot;
+
+#pragma mark - Planning Notifications
+
+        static auto make_notification(const session_snapshot &session,
+                                      notification_type type,
+                                      time_t today_timestamp) -> user_notifications::notification;
+
+        static auto make_plan(const snapshot &snapshot) -> notifications_list;
+
+#pragma mark - Getting Shared Instance
+
+        static auto shared() -> notification_planner &;
+
+        ~notification_planner();
+
+#pragma mark - Registering Clients
+
+        void add_client(client_t client, plan_callback_t plan_callback);
+        void remove_client(client_t client);
+
+#pragma mark - Requesting Plans
+
+        // Takes a snapshot of sessions and plans notifications on the worker thread.
+        // Only the latest requested plan of a client is delivered.
+        void enqueue(client_t client,
+                     const sessions_list &sessions,
+                     const activity_list &activities);
+
+        // Plans notifications synchronously, discarding pending plans of the client.
+        void plan_now(client_t client,
+                      const sessions_list &sessions,
+                      const activity_list &activities);
+
+        auto has_pending_plan(client_t client) const -> bool;
+
+        // Blocks until the worker has planned everything enqueued so far,
+        // and delivers the results.
+        void wait_until_idle();
+
+    private:
+        static constexpr size_t queue_capacity = 64;
+
+        struct plan {
+            client_t client = nullptr;
+            size_t generation = 0;
+            notifications_list notifications;
+        };
+
+        struct client_state {
+            plan_callback_t plan_callback;
+            size_t generation = 0;
+            size_t delivered_generation = 0;
+        };
+
+        std::unordered_map<client_t, client_state> clients;
+
+        // Generations are unique across clients, so that plans of removed client
+        // are never delivered to a new client at the same address.
+        size_t last_generation = 0;
+
+        spsc_queue<snapshot, queue_capacity> snapshots;
+        spsc_queue<plan, queue_capacity> plans;
+
+        size_t enqueued_count = 0;
+        std::atomic<size_t> processed_count = 0;
+
+        std::thread worker;
+        std::mutex wake_mutex;
+        std::condition_variable wake_condition;
+        std::atomic<bool> is_stopping = false;
+
+        notification_planner() = default;
+
+        void start_worker_if_needed();
+        void run_worker();
+
+        void drain();
+        void deliver(plan plan);
+    };
+}
+
+#endif//STRATEGR_NOTIFICATIONPLANNER_H
@@ -0,0 +1,227 @@
+#include <algorithm>
+#include <cstdlib>
+
+#include "notificationscheduler.h"
+
+namespace stg {
+    constexpr auto *notifications_dictionary_key = "activeURLs";
+
+#pragma mark - Getting Shared Instance
+
+    auto notification_scheduler::shared() -> notification_scheduler & {
+        static auto instance = notification_scheduler();
+        return instance;
+    }
+
+#pragma mark - Registering Clients
+
+    void notification_scheduler::add_client(client_t client, time_change_callback_t time_change_callback) {
+        clients[client].time_change_callback = std::move(time_change_callback);
+    }
+
+    void notification_scheduler::remove_client(client_t client) {
+        auto client_it = clients.find(client);
+        if (client_it == clients.end())
+            return;
+
+        live_deliveries_count -= client_it->second.queued_count;
+        clients.erase(client_it);
+
+        update_polling_timer();
+
+        if (clients.empty()) {
+            flush();
+
+            queue = {};
+            live_deliveries_count = 0;
+        } else {
+            compact_queue_if_needed();
+        }
+    }
+
+#pragma mark - Registering Deliveries
+
+    void notification_scheduler::register_deliveries(client_t client, const notifications_list &notifications) {
+        auto &state = clients[client];
+
+        // Previously queued deliveries of this client become stale
+        // and are dropped lazily when they reach the top of the queue.
+        live_deliveries_count -= state.queued_count;
+        state.generation++;
+        state.queued_count = 0;
+        state.deliveries = notifications;
+
+        auto current_seconds = time_utils::current_seconds();
+        for (auto i = size_t(0); i < state.deliveries.size(); ++i) {
+            auto delivery_time = state.deliveries[i].relative_delivery_time();
+            if (delivery_time < current_seconds)
+                continue;
+
+            queue.push(delivery{delivery_time, client, state.generation, i});
+            state.queued_count++;
+        }
+
+        live_deliveries_count += state.queued_count;
+
+        compact_queue_if_needed();
+    }
+
+    void notification_scheduler::unregister_deliveries(client_t client) {
+        auto client_it = clients.find(client);
+        if (client_it == clients.end())
+            return;
+
+        auto &state = client_it->second;
+
+        live_deliveries_count -= state.queued_count;
+        state.generation++;
+        state.queued_count = 0;
+        state.deliveries.clear();
+
+        compact_queue_if_needed();
+    }
+
+    auto notification_scheduler::is_stale(const delivery &delivery) const -> bool {
+        auto client_it = clients.find(delivery.client);
+        return client_it == clients.end() || client_it->second.generation != delivery.generation;
+    }
+
+    void notification_scheduler::compact_queue_if_needed() {
+        if (queue.size() <= 2 * live_deliveries_count + 32)
+            return;
+
+        std::vector<delivery> live_deliveries;
+        live_deliveries.reserve(live_deliveries_count);
+
+        while (!queue.empty()) {
+            if (!is_stale(queue.top()))
+                live_deliveries.push_back(queue.top());
+
+            queue.pop();
+        }
+
+        queue = decltype(queue)(std::greater<>(), std::move(live_deliveries));
+    }
+
+#pragma mark - Polling For Due Deliveries
+
+    void notification_scheduler::start_polling(client_t client, timer::seconds interval) {
+        clients[client].polling_interval = interval;
+        update_polling_timer();
+    }
+
+    void notification_scheduler::stop_polling(client_t client) {
+        auto client_it = clients.find(client);
+        if (client_it == clients.end())
+            return;
+
+        client_it->second.polling_interval = 0;
+        update_polling_timer();
+    }
+
+    void notification_scheduler::update_polling_timer() {
+        timer::seconds interval = 0;
+        for (auto &[_, state] : clients) {
+            if (state.polling_interval > 0 && (interval == 0 || state.polling_interval < interval))
+                interval = state.polling_interval;
+        }
+
+        if (interval == 0) {
+            polling_timer = nullptr;
+            polling_interval = 0;
+            last_poll_time = 0;
+            return;
+        }
+
+        if (polling_timer && interval == polling_interval)
+            return;
+
+        polling_interval = interval;
+        polling_timer = timer::schedule(interval, true, [this] { poll(); });
+    }
+
+    void notification_scheduler::poll() {
+        auto current_seconds = time_utils::current_seconds();
+
+        if (last_poll_time && std::abs((int) current_seconds - (int) last_poll_time) > 4 * polling_interval) {
+            // If time difference between two polls was too big,
+            // this probably means that the system time had changed, we need to reschedule.
+            handle_time_change();
+        }
+
+        last_poll_time = current_seconds;
+
+        // For every client we have to send only the last notification for which
+        // current time >= delivery time, the earlier ones are already stale.
+        std::unordered_map<client_t, delivery> last_due_deliveries;
+
+        while (!queue.empty() && queue.top().delivery_time <= current_seconds) {
+            auto due_delivery = queue.top();
+            queue.pop();
+
+            if (is_stale(due_delivery))
+                continue;
+
+            clients[due_delivery.client].queued_count--;
+            live_deliveries_count--;
+
+            last_due_deliveries.insert_or_assign(due_delivery.client, due_delivery);
+        }
+
+        if (!last_due_deliveries.empty() && user_notifications::backend::immediate_notifications_enabled()) {
+            std::vector<delivery> sorted_deliveries;
+            sorted_deliveries.reserve(last_due_deliveries.size());
+
+            for (auto &[_, due_delivery] : last_due_deliveries)
+                sorted_deliveries.push_back(due_delivery);
+
+            std::sort(sorted_deliveries.begin(),
+                      sorted_deliveries.end(),
+                      [](const delivery &lhs, const delivery &rhs) { return rhs > lhs; });
+
+            for (auto &due_delivery : sorted_deliveries) {
+                const auto &notification = clients[due_delivery.client].deliveries[due_delivery.index];
+                user_notifications::backend::send_notification(notification);
+            }
+        }
+
+        flush();
+    }
+
+    void notification_scheduler::handle_time_change() {
+        std::vector<time_change_callback_t> callbacks;
+        for (auto &[_, state] : clients) {
+            if (state.time_change_callback)
+                callbacks.push_back(state.time_change_callback);
+        }
+
+        for (auto &callback : callbacks)
+            callback();
+    }
+
+#pragma mark - Accessing Persisted Identifiers
+
+    auto notification_scheduler::identifiers_storage() -> user_notifications::storage & {
+        if (clients.empty() || !cached_storage)
+            cached_storage = user_notifications::storage::persisted(notifications_dictionary_key);
+
+        return *cached_storage;
+    }
+
+    void notification_scheduler::identifiers_storage_did_change() {
+        storage_is_dirty = true;
+
+        if (clients.empty())
+            flush();
+    }
+
+    void notification_scheduler::flush() {
+        if (storage_is_dirty && cached_storage)
+            cached_storage->persist_at(notifications_dictionary_key);
+
+        storage_is_dirty = false;
+
+        if (clients.empty())
+            cached_storage = std::nullopt;
+    }
+}
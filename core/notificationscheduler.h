@@ -0,0 +1,114 @@
+#ifndef STRATEGR_NOTIFICATIONSCHEDULER_H
+#define STRATEGR_NOTIFICATIONSCHEDULER_H
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+#include "notifications.h"
+#include "time_utils.h"
+#include "timer.h"
+
+namespace stg {
+
+    // Process-wide service shared by the notifiers of all open strategies.
+    //
+    // It keeps a single priority queue of upcoming deliveries, runs a single polling timer
+    // and caches the persisted notifications identifiers dictionary,
+    // so that the cost of having many documents open stays close to that of one.
+
+    class notification_scheduler {
+    public:
+#pragma mark - Type Aliases
+
+        using seconds = time_utils::seconds;
+        using client_t = const void *;
+        using notifications_list = std::vector<user_notifications::notification>;
+        using time_change_callback_t = std::function<void()>;
+
+#pragma mark - Getting Shared Instance
+
+        static auto shared() -> notification_scheduler &;
+
+#pragma mark - Registering Clients
+
+        // Clients are notified via time_change_callback when the system time changes,
+        // so that they can register their deliveries again.
+        void add_client(client_t client, time_change_callback_t time_change_callback = nullptr);
+        void remove_client(client_t client);
+
+#pragma mark - Registering Deliveries
+
+        // Replaces previously registered deliveries of the client.
+        // Stale notifications are ignored.
+        void register_deliveries(client_t client, const notifications_list &notifications);
+        void unregister_deliveries(client_t client);
+
+#pragma mark - Polling For Due Deliveries
+
+        void start_polling(client_t client, timer::seconds interval);
+        void stop_polling(client_t client);
+
+        void poll();
+
+#pragma mark - Accessing Persisted Identifiers
+
+        // While there are registered clients, the dictionary is cached in memory
+        // and its changes are written in batches on the next poll or
+        // when the last client is removed.
+        // Otherwise, it is read from and written to the persistent storage directly.
+        auto identifiers_storage() -> user_notifications::storage &;
+        void identifiers_storage_did_change();
+
+        void flush();
+
+    private:
+        struct delivery {
+            seconds delivery_time;
+            client_t client;
+            size_t generation;
+            size_t index;
+
+            friend auto operator>(const delivery &lhs, const delivery &rhs) -> bool {
+                if (lhs.delivery_time != rhs.delivery_time)
+                    return lhs.delivery_time > rhs.delivery_time;
+
+                return lhs.index > rhs.index;
+            }
+        };
+
+        struct client_state {
+            time_change_callback_t time_change_callback;
+            timer::seconds polling_interval = 0;
+
+            notifications_list deliveries;
+            size_t generation = 0;
+            size_t queued_count = 0;
+        };
+
+        std::unordered_map<client_t, client_state> clients;
+
+        std::priority_queue<delivery, std::vector<delivery>, std::greater<>> queue;
+        size_t live_deliveries_count = 0;
+
+        std::shared_ptr<timer> polling_timer;
+        timer::seconds polling_interval = 0;
+        seconds last_poll_time = 0;
+
+        std::optional<user_notifications::storage> cached_storage;
+        bool storage_is_dirty = false;
+
+        notification_scheduler() = default;
+
+        auto is_stale(const delivery &delivery) const -> bool;
+        void compact_queue_if_needed();
+
+        void update_polling_timer();
+        void handle_time_change();
+    };
+}
+
+#endif//STRATEGR_NOTIFICATIONSCHEDULER_H
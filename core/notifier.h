@@ -10,7 +10,9 @@
 #include <string>
 #include <unordered_set>
 
+#include "notificationplanner.h"
 #include "notifications.h"
+#include "notificationscheduler.h"
 #include "stgstring.h"
 #include "strategy.h"
 #include "time_utils.h"
@@ -21,22 +23,16 @@ namespace stg {
 
 #pragma mark - Notification
 
-    enum class notification_type {
-        prepare_start,
-        start,
-        prepare_end,
-        end,
-        prepare_strategy_end,
-        strategy_end
-    };
-
     auto session_notification(const session &session,
+                              const activity_list &activities,
                               notification_type type) -> user_notifications::notification;
 
 #pragma mark - Notifier
 
     // This class supports two methods for generating notifications:
     // polling (more suitable for desktop) and scheduling (more suitable for mobile).
+    // Polling and persisting of identifiers is delegated to the shared notification_scheduler,
+    // notifications for sessions changes are built by the shared notification_planner.
 
     class notifier {
     public:
@@ -90,26 +86,21 @@ namespace stg {
         static void reset_active_files();
 
     private:
-        static void remove_stale_from(notifications_list &notifications);
-
         const strategy &strategy;
         std::optional<file_bookmark> _file;
 
-        std::shared_ptr<timer> polling_timer;
         std::shared_ptr<timer> on_change_timer;
-
-        seconds last_poll_time = 0;
+        scoped_connection sessions_connection;
 
         notifications_list _scheduled_notifications;
-        notifications_list _upcoming_notifications;
 
 #pragma mark - Responding To Strategy Changes
 
         void on_sessions_change();
 
-#pragma mark - Sending Immeadiate Notification
+#pragma mark - Applying Planned Notifications
 
-        void send_now_if_needed(seconds polling_seconds_interval);
+        void apply(notifications_list notifications);
 
 #pragma mark - Reading & Writing to Persistent Dictionary
 
@@ -16,7 +16,7 @@ namespace stg {
         std::vector<overview_item> result;
 
         auto prev_origin_x = 0;
-        for (auto &item : activity_sessions.overview()) {
+        for (auto &item : activity_sessions.overview(strategy.activities())) {
             auto current_width = std::round(item.duration_percentage * width());
             auto origin_x = std::round(item.begin_percentage * width());
 
@@ -9,14 +9,28 @@ namespace stg {
     }
 
     void resize_operation::fill_slots(index_t from_index, index_t till_index) {
-        time_slots->fill_slots(from_index, till_index);
+        changed_bounds = changed_bounds.merged(time_slots->fill_slots(from_index, till_index));
     }
 
     void resize_operation::fill_slots_shifting(index_t from_index, index_t till_index) {
-        time_slots->fill_slots_shifting(from_index, till_index);
+        changed_bounds = changed_bounds.merged(time_slots->fill_slots_shifting(from_index, till_index));
     }
 
     auto resize_operation::state_changed() -> bool {
-        return time_slots->data() != initial_time_slots;
+        if (changed_bounds.empty())
+            return false;
+
+        if (time_slots->version() == initial_time_slots.version())
+            return false;
+
+        if (time_slots->content_hash() != initial_time_slots.content_hash())
+            return true;
+
+        for (auto i = changed_bounds.start_index; i <= changed_bounds.end_index; i++) {
+            if ((*time_slots)[i] != initial_time_slots[i])
+                return true;
+        }
+
+        return false;
     }
 }
@@ -17,11 +17,15 @@ namespace stg {
         void fill_slots(index_t from_index, index_t till_index);
         void fill_slots_shifting(index_t from_index, index_t till_index);
 
+        // Compares versions and content hashes first,
+        // then only slots that might have been changed during the operation.
         auto state_changed() -> bool;
 
     private:
         time_slots_state *time_slots;
-        time_slots_state::data_t initial_time_slots = time_slots->data();
+        time_slots_snapshot initial_time_slots = time_slots->snapshot().paged();
+
+        time_slots_state::bounds changed_bounds;
     };
 }
 
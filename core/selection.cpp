@@ -3,72 +3,116 @@
 //
 
 #include <algorithm>
+#include <numeric>
 
 #include "selection.h"
 
+#pragma mark - Grouped Selection Element
+
+stg::index_t stg::grouped_selection_element::front() const {
+    return first_index;
+}
+
+stg::index_t stg::grouped_selection_element::back() const {
+    return last_index;
+}
+
+stg::index_t stg::grouped_selection_element::size() const {
+    return last_index - first_index + 1;
+}
+
+#pragma mark - Selection
+
+template<class Predicate>
+bool stg::selection::all_selected_slots(const Predicate &predicate) const {
+    for (const auto &run : _grouped) {
+        for (auto index = run.first_index; index <= run.last_index; index++) {
+            if (!predicate(index))
+                return false;
+        }
+    }
+
+    return true;
+}
+
 stg::selection::selection(const stg::strategy &strategy)
-    : strategy(strategy) {
-    add_on_change_callback([this] { reload(); });
+    : strategy(strategy),
+      selected(strategy.number_of_time_slots()) {
 }
 
 void stg::selection::set_selected_at(index_t slot_index, bool is_selected) {
+    fit_to_time_slots();
     make_safe(slot_index);
 
-    auto found_it = std::find(begin(), end(), slot_index);
-    auto already_selected = found_it != end();
-
-    if (already_selected && is_selected) {
+    if (has_selected(slot_index) == is_selected)
         return;
-    } else if (already_selected && !is_selected) {
-        erase(found_it);
-    } else if (is_selected) {
-        push_back(slot_index);
-        std::sort(begin(), end());
+
+    if (is_selected) {
+        select_run(slot_index, slot_index);
+    } else {
+        deselect_at(slot_index);
     }
 
     on_change_event();
 }
 
 void stg::selection::reset_with(std::vector<index_t> slot_indices) {
-    assign(slot_indices.begin(), slot_indices.end());
-    std::sort(begin(), end());
+    fit_to_time_slots();
+
+    selected.reset();
+
+    for (auto slot_index : slot_indices) {
+        make_safe(slot_index);
+        selected.set(slot_index);
+    }
+
+    rebuild_grouped();
 
     on_change_event();
 }
 
-
 void stg::selection::toggle_at(index_t slot_index) {
+    fit_to_time_slots();
     make_safe(slot_index);
 
-    auto found_it = std::find(begin(), end(), slot_index);
-    auto already_selected = found_it != end();
-
-    if (already_selected) {
-        erase(found_it);
+    if (has_selected(slot_index)) {
+        deselect_at(slot_index);
     } else {
-        push_back(slot_index);
-        std::sort(begin(), end());
+        select_run(slot_index, slot_index);
     }
 
     on_change_event();
 }
 
 void stg::selection::deselect_all() {
-    clear();
+    selected.reset();
+    selected_count = 0;
+
+    _grouped.clear();
+    indices_are_valid = false;
+
     _is_clicked = false;
 
     on_change_event();
 }
 
 void stg::selection::select_all() {
-    resize(strategy.number_of_time_slots());
+    fit_to_time_slots();
+
+    selected.set();
+    selected_count = (index_t) selected.size();
+
+    _grouped.clear();
+    if (selected_count > 0)
+        _grouped.push_back({0, selected_count - 1});
 
-    std::iota(begin(), end(), 0);
+    indices_are_valid = false;
 
     on_change_event();
 }
 
 void stg::selection::fill(index_t from_index, index_t to_index) {
+    fit_to_time_slots();
     make_safe(from_index);
     make_safe(to_index);
 
@@ -76,14 +120,38 @@ void stg::selection::fill(index_t from_index, index_t to_index) {
         std::swap(from_index, to_index);
     }
 
-    for (auto i = from_index; i <= to_index; i++) {
-        if (!has_selected(i))
-            push_back(i);
+    select_run(from_index, to_index);
+
+    on_change_event();
+}
+
+bool stg::selection::empty() const {
+    return selected_count == 0;
+}
+
+stg::index_t stg::selection::size() const {
+    return selected_count;
+}
+
+stg::index_t stg::selection::front() const {
+    return _grouped.front().first_index;
+}
+
+const std::vector<stg::index_t> &stg::selection::indices() const {
+    if (indices_are_valid)
+        return _indices;
+
+    _indices.resize(selected_count);
+
+    auto it = _indices.begin();
+    for (const auto &run : _grouped) {
+        std::iota(it, it + run.size(), run.first_index);
+        it += run.size();
     }
 
-    std::sort(begin(), end());
+    indices_are_valid = true;
 
-    on_change_event();
+    return _indices;
 }
 
 bool stg::selection::is_continuous() const {
@@ -91,45 +159,21 @@ bool stg::selection::is_continuous() const {
 }
 
 bool stg::selection::only_empty_selected() const {
-    return std::find_if(begin(), end(), [this](auto index) {
-               return strategy.time_slots()[index].activity != stg::strategy::no_activity;
-           }) == end();
+    return all_selected_slots([this](auto index) {
+        return strategy.time_slots()[index].activity == stg::strategy::no_activity;
+    });
 }
 
-
 bool stg::selection::only_non_empty_selected() const {
-    return std::find_if(begin(), end(), [this](auto index) {
-               return strategy.time_slots()[index].activity == stg::strategy::no_activity;
-           }) == end();
+    return all_selected_slots([this](auto index) {
+        return strategy.time_slots()[index].activity != stg::strategy::no_activity;
+    });
 }
 
 bool stg::selection::has_selected(index_t slot_index) const {
-    return std::find(begin(), end(), slot_index) != end();
-}
-
-void stg::selection::reload() {
-    grouped_selection new_grouped;
-    grouped_selection_element current_item;
-
-    for (auto i = begin(); i != end(); ++i) {
-        auto current_index = *i;
-        auto previous = i != begin()
-                            ? std::make_optional(*prev(i))
-                            : std::nullopt;
-
-        if (!previous || current_index == *previous + 1) {
-            current_item.push_back(current_index);
-        } else {
-            new_grouped.push_back(current_item);
-            current_item = {current_index};
-        }
-
-        if (i == prev(end())) {
-            new_grouped.push_back(current_item);
-        }
-    }
-
-    _grouped = new_grouped;
+    return slot_index >= 0 &&
+           slot_index < (index_t) selected.size() &&
+           selected.test(slot_index);
 }
 
 bool stg::selection::is_clicked() const {
@@ -147,11 +191,11 @@ const stg::grouped_selection &stg::selection::grouped() const {
 }
 
 bool stg::selection::is_all_selected() const {
-    return size() == strategy.number_of_time_slots();
+    return selected_count == (index_t) strategy.number_of_time_slots();
 }
 
 bool stg::selection::is_boundary(stg::index_t slot_index) const {
-    return (!has_selected(slot_index - 1) && has_selected(slot_index)) || (has_selected(slot_index - 1) && !has_selected(slot_index));
+    return has_selected(slot_index - 1) != has_selected(slot_index);
 }
 
 void stg::selection::make_safe(int &index) {
@@ -161,3 +205,111 @@ void stg::selection::make_safe(int &index) {
         index = strategy.number_of_time_slots() - 1;
     }
 }
+
+#pragma mark - Maintaining Runs
+
+// Number of time slots can change after the selection was made,
+// in which case slots that are gone are dropped from the selection.
+void stg::selection::fit_to_time_slots() {
+    auto number_of_time_slots = (index_t) strategy.number_of_time_slots();
+    if ((index_t) selected.size() == number_of_time_slots)
+        return;
+
+    selected.resize(number_of_time_slots);
+
+    auto last_index = number_of_time_slots - 1;
+    auto it = first_run_ending_at_or_after(last_index);
+
+    if (it != _grouped.end() && it->first_index <= last_index) {
+        it->last_index = last_index;
+        it++;
+    }
+
+    _grouped.erase(it, _grouped.end());
+
+    selected_count = 0;
+    for (const auto &run : _grouped)
+        selected_count += run.size();
+
+    indices_are_valid = false;
+}
+
+// Merges the run with all the runs it overlaps or touches.
+void stg::selection::select_run(index_t first_index, index_t last_index) {
+    auto first_it = first_run_ending_at_or_after(first_index - 1);
+    auto last_it = std::upper_bound(first_it, _grouped.end(), last_index + 1,
+                                    [](auto index, const auto &run) {
+                                        return index < run.first_index;
+                                    });
+
+    auto newly_selected_count = last_index - first_index + 1;
+    auto merged = grouped_selection_element{first_index, last_index};
+
+    for (auto it = first_it; it != last_it; it++) {
+        auto overlap = std::min(it->last_index, last_index) - std::max(it->first_index, first_index) + 1;
+        if (overlap > 0)
+            newly_selected_count -= overlap;
+
+        merged.first_index = std::min(merged.first_index, it->first_index);
+        merged.last_index = std::max(merged.last_index, it->last_index);
+    }
+
+    auto insert_it = _grouped.erase(first_it, last_it);
+    _grouped.insert(insert_it, merged);
+
+    selected.set(first_index, last_index - first_index + 1, true);
+    selected_count += newly_selected_count;
+
+    indices_are_valid = false;
+}
+
+// Splits the run containing the slot index.
+void stg::selection::deselect_at(index_t slot_index) {
+    auto it = first_run_ending_at_or_after(slot_index);
+
+    if (it->first_index == it->last_index) {
+        _grouped.erase(it);
+    } else if (it->first_index == slot_index) {
+        it->first_index++;
+    } else if (it->last_index == slot_index) {
+        it->last_index--;
+    } else {
+        auto tail = grouped_selection_element{slot_index + 1, it->last_index};
+        it->last_index = slot_index - 1;
+
+        _grouped.insert(std::next(it), tail);
+    }
+
+    selected.reset(slot_index);
+    selected_count--;
+
+    indices_are_valid = false;
+}
+
+void stg::selection::rebuild_grouped() {
+    _grouped.clear();
+    selected_count = 0;
+
+    for (auto index = selected.find_first();
+         index != boost::dynamic_bitset<>::npos;
+         index = selected.find_next(index)) {
+        auto slot_index = (index_t) index;
+
+        if (!_grouped.empty() && _grouped.back().last_index == slot_index - 1) {
+            _grouped.back().last_index = slot_index;
+        } else {
+            _grouped.push_back({slot_index, slot_index});
+        }
+
+        selected_count++;
+    }
+
+    indices_are_valid = false;
+}
+
+stg::grouped_selection::iterator stg::selection::first_run_ending_at_or_after(index_t slot_index) {
+    return std::lower_bound(_grouped.begin(), _grouped.end(), slot_index,
+                            [](const auto &run, auto index) {
+                                return run.last_index < index;
+                            });
+}
@@ -9,16 +9,35 @@
 #include <optional>
 #include <vector>
 
+#include <boost/dynamic_bitset.hpp>
+
 #include "notifiableonchange.h"
 #include "strategy.h"
 
 namespace stg {
     using index_t = strategy::time_slot_index_t;
-    using grouped_selection_element = std::vector<index_t>;
+
+    // Continuous run of selected slots, both ends are inclusive.
+    struct grouped_selection_element {
+        index_t first_index = 0;
+        index_t last_index = 0;
+
+        index_t front() const;
+        index_t back() const;
+        index_t size() const;
+
+        friend bool operator==(const grouped_selection_element &lhs,
+                               const grouped_selection_element &rhs) {
+            return lhs.first_index == rhs.first_index &&
+                   lhs.last_index == rhs.last_index;
+        }
+    };
+
     using grouped_selection = std::vector<grouped_selection_element>;
 
-    class selection : public std::vector<index_t>,
-                      public notifiable_on_change {
+    // Selected slots are kept in a bitset, along with a sorted list of runs
+    // that is updated in place, so both lookups and grouping don't need a full rescan.
+    class selection : public notifiable_on_change {
     public:
         explicit selection(const stg::strategy &strategy);
 
@@ -30,6 +49,13 @@ namespace stg {
         void select_all();
         void fill(index_t from_index, index_t to_index);
 
+        bool empty() const;
+        index_t size() const;
+        index_t front() const;
+
+        // Sorted selected indices, materialized on demand.
+        const std::vector<index_t> &indices() const;
+
         bool is_continuous() const;
 
         bool only_empty_selected() const;
@@ -40,8 +66,6 @@ namespace stg {
 
         bool is_boundary(index_t slot_index) const;
 
-        void reload();
-
         bool is_clicked() const;
         void set_is_clicked(bool is_clicked);
 
@@ -50,13 +74,27 @@ namespace stg {
     private:
         const stg::strategy &strategy;
 
+        boost::dynamic_bitset<> selected;
+        index_t selected_count = 0;
+
         grouped_selection _grouped;
 
+        mutable std::vector<index_t> _indices;
+        mutable bool indices_are_valid = true;
+
+        bool _is_clicked = false;
+
         void make_safe(int &index);
+        void fit_to_time_slots();
 
-        std::function<void(int)> get_slot_height;
+        void select_run(index_t first_index, index_t last_index);
+        void deselect_at(index_t slot_index);
+        void rebuild_grouped();
 
-        bool _is_clicked = false;
+        grouped_selection::iterator first_run_ending_at_or_after(index_t slot_index);
+
+        template<class Predicate>
+        bool all_selected_slots(const Predicate &predicate) const;
     };
 }
 
@@ -3,7 +3,6 @@
 //
 
 #include "session.h"
-#include "activity.h"
 #include "time_utils.h"
 
 namespace stg {
@@ -81,12 +80,7 @@ namespace stg {
 
     auto operator<<(std::ostream &os, const session &session) -> std::ostream & {
         os << "session(";
-
-        if (session.activity) {
-            os << *session.activity;
-        } else {
-            os << "none";
-        }
+        os << session.activity;
 
         os << ", length: " << session.length();
         os << ", begin_time: " << session.begin_time();
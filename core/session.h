@@ -9,14 +9,14 @@
 #include "timeslot.h"
 
 namespace stg {
-    struct activity;
-
+    // Session refers to its activity by handle,
+    // so it can be kept around after the activity is removed from the list.
     struct session {
         using length_t = int;
         using minutes = time_slot::minutes;
 
         std::vector<time_slot> time_slots{};
-        activity *activity = time_slot::no_activity;
+        activity_id activity = time_slot::no_activity;
 
         auto length() const -> length_t;
         auto begin_time() const -> minutes;
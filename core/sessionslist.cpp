@@ -8,21 +8,30 @@
 
 namespace stg {
 
+    sessions_list::sessions_list(data_t data) : sessions_list_base(std::move(data)) {
+        update_session_indices();
+    }
+
+    void sessions_list::reset_with(data_t data) {
+        sessions_list_base::reset_with(std::move(data));
+        update_session_indices();
+    }
+
     auto sessions_list::session_index_for_time_slot_index(index_t time_slot_index) const -> index_t {
-        index_t slots_count = 0;
+        if (time_slot_index < 0 || time_slot_index >= static_cast<index_t>(session_indices.size()))
+            return -1;
 
-        for (const auto &session : _data) {
-            auto first_slot_index = slots_count;
-            auto next_slot_index = slots_count + static_cast<index_t>(session.length());
+        return session_indices[time_slot_index];
+    }
 
-            if (first_slot_index <= time_slot_index && time_slot_index < next_slot_index) {
-                return static_cast<index_t>(&session - &_data[0]);
-            }
+    void sessions_list::update_session_indices() {
+        session_indices.clear();
 
-            slots_count = next_slot_index;
+        for (auto session_index = 0; session_index < size(); session_index++) {
+            session_indices.insert(session_indices.end(),
+                                   _data[session_index].length(),
+                                   session_index);
         }
-
-        return -1;
     }
 
     void sessions_list::recalculate(const time_slots_state &time_slots) {
@@ -32,11 +41,11 @@ namespace stg {
 
         for (const auto &time_slot : time_slots) {
             auto time_slot_index = &time_slot - &time_slots[0];
-            auto *previous_activity = time_slot_index > 0
-                                          ? time_slots[(index_t) time_slot_index - 1].activity
-                                          : time_slot::no_activity;
+            auto previous_activity = time_slot_index > 0
+                                         ? time_slots[(index_t) time_slot_index - 1].activity
+                                         : time_slot::no_activity;
 
-            auto *current_activity = time_slot.activity;
+            auto current_activity = time_slot.activity;
 
             bool activity_changed = previous_activity != current_activity;
 
@@ -57,6 +66,7 @@ namespace stg {
         }
 
         _data = result;
+        update_session_indices();
 
         on_change_event();
     }
@@ -75,19 +85,20 @@ namespace stg {
         return "sessions_list";
     }
 
-    auto sessions_list::overview() const -> std::vector<overview_item> {
+    auto sessions_list::overview(const activity_list &activities) const -> std::vector<overview_item> {
         if (_data.empty())
             return {};
 
         auto overall_begin_time = _data.front().begin_time();
 
         std::vector<overview_item> result;
-        auto make_overview_item = [overall_begin_time, this](auto &session) {
+        auto make_overview_item = [overall_begin_time, &activities, this](auto &session) {
             auto duration_percentage = (float) session.duration() / duration();
             auto begin_percentage = (float) (session.begin_time() - overall_begin_time) / duration();
 
-            auto color = session.activity
-                             ? std::make_optional(session.activity->color())
+            const auto *activity = activities.get(session.activity);
+            auto color = activity
+                             ? std::make_optional(activity->color())
                              : std::nullopt;
 
             return overview_item{duration_percentage,
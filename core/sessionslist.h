@@ -9,6 +9,7 @@
 #include <optional>
 
 #include "activity.h"
+#include "activitylist.h"
 #include "notifiableonchange.h"
 #include "privatelist.h"
 #include "session.h"
@@ -41,6 +42,7 @@ namespace stg {
         auto get_non_empty() const -> std::vector<session>;
         auto get_bounds_for(index_t session_index) const -> bounds;
 
+        // Returns -1 if there's no such time slot.
         auto session_index_for_time_slot_index(index_t time_slot_index) const -> stg::sessions_list::index_t;
 
         auto session_after(const session &activity_session) const -> const session *;
@@ -49,15 +51,23 @@ namespace stg {
         auto relative_begin_time(const session &session) const -> time_slot::minutes;
         auto duration() const -> time_slot::minutes;
 
-        auto overview() const -> std::vector<overview_item>;
+        // Colors come from activities the sessions' handles resolve to in the given list.
+        auto overview(const activity_list &activities) const -> std::vector<overview_item>;
 
         auto class_print_name() const -> std::string override;
 
     private:
-        using sessions_list_base::sessions_list_base;
+        // Session index of every time slot, so that hit testing is O(1).
+        std::vector<index_t> session_indices;
 
+        sessions_list() = default;
+        explicit sessions_list(data_t data);
+
+        void reset_with(data_t data) override;
         void recalculate(const time_slots_state &time_slots);
 
+        void update_session_indices();
+
         friend strategy;
     };
 }
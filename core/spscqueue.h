@@ -0,0 +1,71 @@
+#ifndef STRATEGR_SPSCQUEUE_H
+#define STRATEGR_SPSCQUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+namespace stg {
+
+    // Bounded lock-free queue for exactly one producer thread and one consumer thread.
+    // One slot is always kept empty to tell a full queue from an empty one.
+
+    template<typename T, size_t Capacity>
+    class spsc_queue {
+    public:
+        static_assert(Capacity >= 2, "stg::spsc_queue capacity must be at least 2");
+
+        spsc_queue() = default;
+        spsc_queue(const spsc_queue &) = delete;
+        auto operator=(const spsc_queue &) -> spsc_queue & = delete;
+
+        // Must be called from the producer thread only.
+        auto try_push(T &&value) -> bool {
+            auto tail = _tail.load(std::memory_order_relaxed);
+            auto next_tail = increment(tail);
+
+            if (next_tail == _head.load(std::memory_order_acquire))
+                return false;
+
+            slots[tail] = std::move(value);
+            _tail.store(next_tail, std::memory_order_release);
+
+            return true;
+        }
+
+        // Must be called from the consumer thread only.
+        auto try_pop() -> std::optional<T> {
+            auto head = _head.load(std::memory_order_relaxed);
+
+            if (head == _tail.load(std::memory_order_acquire))
+                return std::nullopt;
+
+            auto value = std::optional<T>(std::move(slots[head]));
+            slots[head] = T();
+
+            _head.store(increment(head), std::memory_order_release);
+
+            return value;
+        }
+
+        auto empty() const -> bool {
+            return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+        }
+
+    private:
+        static constexpr size_t cache_line_size = 64;
+
+        std::array<T, Capacity> slots{};
+
+        alignas(cache_line_size) std::atomic<size_t> _head = 0;
+        alignas(cache_line_size) std::atomic<size_t> _tail = 0;
+
+        static constexpr auto increment(size_t index) -> size_t {
+            return (index + 1) % Capacity;
+        }
+    };
+}
+
+#endif//STRATEGR_SPSCQUEUE_H
@@ -0,0 +1,33 @@
+#ifndef STRATEGR_STGHASH_H
+#define STRATEGR_STGHASH_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace stg {
+    // Order-aware list hashes are sums of hashes of (index, item) pairs,
+    // so changing one item updates the sum in O(1).
+    using content_hash_t = uint64_t;
+
+    // Finalizer of splitmix64.
+    inline auto mix_hash(uint64_t value) -> content_hash_t {
+        value ^= value >> 30u;
+        value *= 0xbf58476d1ce4e5b9ull;
+        value ^= value >> 27u;
+        value *= 0x94d049bb133111ebull;
+        value ^= value >> 31u;
+
+        return value;
+    }
+
+    inline auto combine_hash(content_hash_t seed, uint64_t value) -> content_hash_t {
+        return mix_hash(seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6u) + (seed >> 2u)));
+    }
+
+    // Contribution of an item to its list's hash.
+    inline auto list_item_hash(size_t index, content_hash_t item_hash) -> content_hash_t {
+        return combine_hash(mix_hash(index), item_hash);
+    }
+}
+
+#endif//STRATEGR_STGHASH_H
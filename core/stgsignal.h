@@ -0,0 +1,231 @@
+#ifndef STRATEGR_STGSIGNAL_H
+#define STRATEGR_STGSIGNAL_H
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <boost/container/small_vector.hpp>
+
+namespace stg {
+
+#pragma mark - Connection
+
+    namespace detail {
+        struct signal_state_base {
+            virtual ~signal_state_base() = default;
+            virtual void disconnect(size_t id) = 0;
+            virtual auto is_connected(size_t id) const -> bool = 0;
+        };
+    }
+
+    // Non-owning handle to a connected listener.
+    // Listener stays connected when the handle is destroyed.
+    class connection {
+    public:
+        connection() = default;
+
+        void disconnect() {
+            if (auto state = _state.lock())
+                state->disconnect(id);
+
+            _state.reset();
+        }
+
+        auto is_connected() const -> bool {
+            auto state = _state.lock();
+            return state && state->is_connected(id);
+        }
+
+    private:
+        template<typename... Args>
+        friend class signal;
+
+        connection(std::weak_ptr<detail::signal_state_base> state, size_t id)
+            : _state(std::move(state)), id(id) {}
+
+        std::weak_ptr<detail::signal_state_base> _state;
+        size_t id = 0;
+    };
+
+    // RAII token: disconnects the listener when destroyed.
+    // It's safe to outlive the signal.
+    class scoped_connection {
+    public:
+        scoped_connection() = default;
+        scoped_connection(connection connection) : _connection(std::move(connection)) {}
+
+        scoped_connection(const scoped_connection &) = delete;
+        auto operator=(const scoped_connection &) -> scoped_connection & = delete;
+
+        scoped_connection(scoped_connection &&other) noexcept
+            : _connection(std::exchange(other._connection, connection())) {}
+
+        auto operator=(scoped_connection &&other) noexcept -> scoped_connection & {
+            if (this != &other) {
+                _connection.disconnect();
+                _connection = std::exchange(other._connection, connection());
+            }
+
+            return *this;
+        }
+
+        ~scoped_connection() {
+            _connection.disconnect();
+        }
+
+        void disconnect() {
+            _connection.disconnect();
+        }
+
+        auto is_connected() const -> bool {
+            return _connection.is_connected();
+        }
+
+    private:
+        connection _connection;
+    };
+
+#pragma mark - Signal
+
+    // Listeners are kept in a flat small-buffer vector and are invoked in order of connection.
+    // Connecting and disconnecting is allowed while the signal is being emitted:
+    // new listeners are invoked starting from the next emission,
+    // disconnected ones are compacted away when the outermost emission ends.
+
+    template<typename... Args>
+    class signal {
+    public:
+        using slot_t = std::function<void(Args...)>;
+
+        signal() = default;
+        signal(const signal &) = delete;
+        auto operator=(const signal &) -> signal & = delete;
+
+        auto connect(slot_t slot) const -> connection {
+            auto id = ++_state->last_id;
+
+            if (_state->emission_depth > 0) {
+                _state->connected_during_emission.push_back(listener{id, std::move(slot)});
+            } else {
+                _state->listeners.push_back(listener{id, std::move(slot)});
+            }
+
+            return connection(_state, id);
+        }
+
+        void operator()(Args... args) const {
+            // Keep state alive, in case a listener destroys the signal.
+            auto state = _state;
+
+            state->emission_depth++;
+
+            // Listeners connected during emission are stored separately,
+            // so the listeners vector is never reallocated here.
+            auto count = state->listeners.size();
+            for (size_t i = 0; i < count; ++i) {
+                auto &listener = state->listeners[i];
+                if (listener.is_connected)
+                    listener.slot(args...);
+            }
+
+            state->emission_depth--;
+
+            if (state->emission_depth == 0)
+                state->finish_emission();
+        }
+
+        auto size() const -> size_t {
+            return _state->connected_count();
+        }
+
+        auto empty() const -> bool {
+            return size() == 0;
+        }
+
+        void disconnect_all() const {
+            for (auto &listener : _state->listeners)
+                listener.is_connected = false;
+
+            _state->connected_during_emission.clear();
+
+            if (_state->emission_depth == 0)
+                _state->finish_emission();
+        }
+
+    private:
+        static constexpr auto inline_listeners_count = 4;
+
+        struct listener {
+            size_t id;
+            slot_t slot;
+            bool is_connected = true;
+        };
+
+        struct state : public detail::signal_state_base {
+            boost::container::small_vector<listener, inline_listeners_count> listeners;
+            std::vector<listener> connected_during_emission;
+
+            size_t last_id = 0;
+            size_t emission_depth = 0;
+
+            void disconnect(size_t id) override {
+                auto it = find(id);
+                if (it != listeners.end()) {
+                    // Slot isn't erased right away, since it might be executing now.
+                    it->is_connected = false;
+
+                    if (emission_depth == 0)
+                        finish_emission();
+
+                    return;
+                }
+
+                connected_during_emission.erase(std::remove_if(connected_during_emission.begin(),
+                                                               connected_during_emission.end(),
+                                                               [id](auto &listener) { return listener.id == id; }),
+                                                connected_during_emission.end());
+            }
+
+            auto is_connected(size_t id) const -> bool override {
+                auto it = std::find_if(listeners.begin(), listeners.end(),
+                                       [id](auto &listener) { return listener.id == id; });
+                if (it != listeners.end())
+                    return it->is_connected;
+
+                return std::any_of(connected_during_emission.begin(),
+                                   connected_during_emission.end(),
+                                   [id](auto &listener) { return listener.id == id; });
+            }
+
+            auto connected_count() const -> size_t {
+                return connected_during_emission.size() +
+                       std::count_if(listeners.begin(), listeners.end(),
+                                     [](auto &listener) { return listener.is_connected; });
+            }
+
+            auto find(size_t id) -> typename decltype(listeners)::iterator {
+                return std::find_if(listeners.begin(), listeners.end(),
+                                    [id](auto &listener) { return listener.id == id; });
+            }
+
+            void finish_emission() {
+                listeners.erase(std::remove_if(listeners.begin(),
+                                               listeners.end(),
+                                               [](auto &listener) { return !listener.is_connected; }),
+                                listeners.end());
+
+                for (auto &listener : connected_during_emission)
+                    listeners.push_back(std::move(listener));
+
+                connected_during_emission.clear();
+            }
+        };
+
+        std::shared_ptr<state> _state = std::make_shared<state>();
+    };
+}
+
+#endif//STRATEGR_STGSIGNAL_H
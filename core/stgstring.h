@@ -6,7 +6,9 @@
 #define STRATEGR_STGSTRING_H
 
 #include <codecvt>
+#include <cstdlib>
 #include <locale>
+#include <memory>
 #include <regex>
 #include <string>
 #include <type_traits>
@@ -57,8 +59,12 @@ namespace stg {
         }
 
         inline std::string utf8_fold_case(const std::string &str) {
-            auto *lowered = (char *) utf8proc_NFKC_Casefold((utf8proc_uint8_t *) str.c_str());
-            return std::string(std::unique_ptr<char>(lowered).get());
+            // utf8proc allocates the result with malloc() and returns null on invalid input.
+            auto lowered = std::unique_ptr<char, decltype(&std::free)>(
+                (char *) utf8proc_NFKC_Casefold((utf8proc_uint8_t *) str.c_str()),
+                &std::free);
+
+            return lowered ? std::string(lowered.get()) : str;
         }
 
         inline void strip_bounding_whitespaces(std::string &str) {
@@ -3,6 +3,7 @@
 #include <map>
 #include <vector>
 
+#include "instrumentation.h"
 #include "json.h"
 #include "persistent.h"
 #include "strategy.h"
@@ -23,27 +24,28 @@ namespace stg {
     }
 
     strategy::strategy(const time_slots_state::data_t &time_slots,
-                       const activity_list::data_t &activities) : _time_slots(time_slots),
-                                                                  _activities(activities),
-                                                                  history(make_history_entry()) {
+                       const activity_list::snapshot_t &activities) : _activities(activities),
+                                                                      _time_slots(time_slots),
+                                                                      history(make_history_entry()) {
 
         time_slots_changed();
         setup_time_slots_callback();
     }
 
-    strategy::strategy(const strategy &other) : _time_slots(other._time_slots.data()),
-                                                _activities(other._activities.data()),
-                                                _sessions(other.sessions().data()),
+    strategy::strategy(const strategy &other) : _activities(other._activities.snapshot()),
+                                                _time_slots(other._time_slots.data()),
                                                 history(make_history_entry()) {
 
+        time_slots_changed();
         setup_time_slots_callback();
     }
 
     auto stg::strategy::operator=(const strategy &other) -> strategy & {
+        // Activities go first, so that the new time slots' handles resolve when they're notified.
+        _activities.reset_with(other.activities().snapshot());
         _time_slots.reset_with(other.time_slots().data());
-        _time_slots.on_change_event();
 
-        _activities.reset_with(other.activities().data());
+        _time_slots.on_change_event();
         _activities.on_change_event();
 
         history = strategy_history(make_history_entry());
@@ -108,8 +110,8 @@ namespace stg {
         std::cout << "imported_events (override: " << override << "): [\n";
 
         if (override) {
-            for (auto &slot : _time_slots._data) {
-                slot.activity = no_activity;
+            for (auto i = 0; i < _time_slots.size(); i++) {
+                _time_slots.set_slot_activity(i, no_activity);
             }
         }
 
@@ -130,12 +132,15 @@ namespace stg {
                 activity_index = _activities.size() - 1;
             }
 
-            auto *activity = activities().at(*activity_index);
+            auto activity = activities().id_at(*activity_index);
             for (auto &slot : slots_for_event) {
                 slot->activity = activity;
             }
         }
 
+        // Slots were changed through pointers, bypassing the content hash.
+        _time_slots.rehash();
+
         _activities.on_change_event();
         time_slots_changed();
 
@@ -262,6 +267,8 @@ namespace stg {
 #pragma mark - Operations On Activities
 
     void strategy::add_activity(const activity &activity) {
+        auto timing = instrumentation::scope("strategy::add_activity");
+
         _activities.add(activity);
 
         commit_to_history();
@@ -274,42 +281,41 @@ namespace stg {
     }
 
     void strategy::delete_activity(activity_index_t activity_index) {
-        _time_slots.remove_activity(_activities.at(activity_index));
+        auto timing = instrumentation::scope("strategy::delete_activity");
+
+        _time_slots.remove_activity(_activities.id_at(activity_index));
         _activities.remove_at_index(activity_index);
 
         commit_to_history();
     }
 
     void strategy::silently_delete_activity(activity_index_t activity_index) {
-        _time_slots.remove_activity(_activities.at(activity_index));
+        _time_slots.remove_activity(_activities.id_at(activity_index));
         _activities.silently_remove_at_index(activity_index);
 
         commit_to_history();
     }
 
     void strategy::edit_activity(activity_index_t activity_index, const activity &new_activity) {
-        auto *old_activity = _activities.at(activity_index);
-        _activities.silently_edit_at_index(activity_index, new_activity);
+        auto timing = instrumentation::scope("strategy::edit_activity");
 
-        auto *updated_activity = _activities.at(activity_index);
-        _time_slots.edit_activity(old_activity, updated_activity);
-
-        _activities.on_change_event();
+        // Time slots keep the activity's handle, but sessions show what's been edited.
+        _activities.edit_at_index(activity_index, new_activity);
+        _sessions.on_change_event();
 
         commit_to_history();
     }
 
     void strategy::silently_edit_activity(activity_index_t activity_index, const activity &new_activity) {
-        auto *const old_activity = _activities.at(activity_index);
         _activities.silently_edit_at_index(activity_index, new_activity);
-
-        auto *const updated_activity = _activities.at(activity_index);
-        _time_slots.edit_activity(old_activity, updated_activity);
+        _sessions.on_change_event();
 
         commit_to_history();
     }
 
     void strategy::drag_activity(activity_index_t from_index, activity_index_t to_index) {
+        auto timing = instrumentation::scope("strategy::drag_activity");
+
         _activities.drag(from_index, to_index);
 
         commit_to_history();
@@ -322,16 +328,16 @@ namespace stg {
     }
 
     void strategy::reorder_activities_by_usage() {
-        std::map<activity *, duration_t> usage;
+        std::map<activity_id, duration_t> usage;
 
         for (const auto &session : sessions()) {
             if (session.activity == no_activity)
                 continue;
 
-            usage[session.activity] += session.duration();
+            usage[session.time_slots.front().activity] += session.duration();
         }
 
-        std::vector<std::pair<activity *, duration_t>> pairs;
+        std::vector<std::pair<activity_id, duration_t>> pairs;
         pairs.reserve(usage.size());
 
         for (const auto &elem : usage) {
@@ -344,20 +350,15 @@ namespace stg {
 
         activity_list::data_t reordered;
         for (auto &elem : pairs) {
-            if (!elem.first)
+            if (!activities().index_of(elem.first))
                 continue;
 
-            auto index = *activities().index_of(elem.first);
-            auto &activity = _activities._data[index];
-
-            reordered.push_back(activity);
+            reordered.push_back(elem.first);
         }
 
-        for (const auto &activity : _activities) {
-            if (std::find_if(reordered.begin(), reordered.end(), [&activity](auto &a) {
-                    return a == activity;
-                }) == reordered.end()) {
-                reordered.push_back(activity);
+        for (auto id : _activities) {
+            if (std::find(reordered.begin(), reordered.end(), id) == reordered.end()) {
+                reordered.push_back(id);
             };
         }
 
@@ -373,22 +374,28 @@ namespace stg {
 
     void strategy::place_activity(activity_index_t activity_index,
                                   const std::vector<time_slot_index_t> &time_slot_indices) {
+        auto timing = instrumentation::scope("strategy::place_activity");
+
         if (!activities().has_index(activity_index))
             return;
 
-        auto *activity = activities().at(activity_index);
+        auto activity = activities().id_at(activity_index);
         _time_slots.set_activity_at_indices(activity, time_slot_indices);
 
         commit_to_history();
     }
 
     void strategy::make_empty_at(const std::vector<time_slot_index_t> &time_slot_indices) {
+        auto timing = instrumentation::scope("strategy::make_empty_at");
+
         _time_slots.set_activity_at_indices(no_activity, time_slot_indices);
 
         commit_to_history();
     }
 
     void strategy::shift_below_time_slot(time_slot_index_t from_index, int length) {
+        auto timing = instrumentation::scope("strategy::shift_below_time_slot");
+
         _time_slots.shift_below(from_index, length);
 
         commit_to_history();
@@ -403,6 +410,8 @@ namespace stg {
     }
 
     void strategy::fill_time_slots_shifting(time_slot_index_t from_index, time_slot_index_t till_index) {
+        auto timing = instrumentation::scope("strategy::fill_time_slots_shifting");
+
         assert("fill_time_slots must be called between begin_resizing() and end_resizing() calls" &&
                current_resize_operation);
 
@@ -410,6 +419,8 @@ namespace stg {
     }
 
     void strategy::fill_time_slots(time_slot_index_t from_index, time_slot_index_t till_index) {
+        auto timing = instrumentation::scope("strategy::fill_time_slots");
+
         assert("fill_time_slots must be called between begin_resizing() and end_resizing() calls" &&
                current_resize_operation);
 
@@ -430,38 +441,48 @@ namespace stg {
         return current_drag_operation != nullptr;
     }
 
+    auto strategy::drag_preview() const -> const sessions_list & {
+        return _drag_preview;
+    }
+
     void strategy::begin_dragging(session_index_t session_index) {
         const auto &session = sessions()[session_index];
         auto initial_indices = global_slot_indices_from_session(session);
 
-        current_drag_operation = std::make_unique<drag_operation>(&_time_slots, initial_indices);
+        current_drag_operation = std::make_unique<drag_operation>(_time_slots,
+                                                                  _drag_time_slots,
+                                                                  initial_indices);
+
+        _drag_preview.recalculate(current_drag_operation->preview());
     }
 
     auto strategy::drag_session(session_index_t session_index,
                                 int distance) -> sessions_list::index_t {
+        auto timing = instrumentation::scope("strategy::drag_session");
+
         assert(current_drag_operation && "drag_session must be called between "
                                          "begin_dragging() and end_dragging() calls");
 
         if (session_index < 0 ||
-            session_index > sessions().size() - 1 ||
+            session_index > _drag_preview.size() - 1 ||
             distance == 0) {
             return session_index;
         }
 
-        const auto &session = sessions()[session_index];
+        const auto &session = _drag_preview[session_index];
         if (session.activity == stg::strategy::no_activity) {
             return session_index;
         }
 
         auto new_indexes = current_drag_operation->record_drag(session.time_slots, distance);
+        if (new_indexes.empty()) {
+            return session_index;
+        }
 
-        time_slots().on_change_event();
-
-        auto new_session_index = new_indexes.empty()
-                                     ? session_index
-                                     : sessions().session_index_for_time_slot_index(new_indexes.front());
+        // Only the preview is recalculated, model listeners aren't notified.
+        _drag_preview.recalculate(current_drag_operation->preview());
 
-        return new_session_index;
+        return _drag_preview.session_index_for_time_slot_index(new_indexes.front());
     }
 
     auto strategy::global_slot_indices_from_session(const session &session) const -> std::vector<time_slot_index_t> {
@@ -477,23 +498,39 @@ namespace stg {
     }
 
     void strategy::end_dragging() {
+        auto timing = instrumentation::scope("strategy::end_dragging");
+
         assert(current_drag_operation && "end_dragging must be called after begin_dragging()");
 
-        if (current_drag_operation->state_changed()) {
+        auto operation = std::move(current_drag_operation);
+
+        if (operation->state_changed()) {
+            _time_slots.reset_with(operation->preview().snapshot());
+            _time_slots.on_change_event();
+
             commit_to_history();
         }
 
-        current_drag_operation.reset();
+        reset_drag_preview();
     }
 
     void strategy::cancel_dragging() {
-        _time_slots.reset_with(current_drag_operation->initial_state());
         current_drag_operation.reset();
 
-        time_slots_changed();
+        reset_drag_preview();
+    }
+
+    void strategy::reset_drag_preview() {
+        if (_drag_preview.empty())
+            return;
+
+        _drag_preview.reset_with({});
+        _drag_preview.on_change_event();
     }
 
     void strategy::copy_session(session_index_t session_index, time_slot_index_t begin_index) {
+        auto timing = instrumentation::scope("strategy::copy_session");
+
         const auto &session = sessions()[session_index];
         if (!session.activity) {
             return;
@@ -504,7 +541,7 @@ namespace stg {
                   copied_session_indices.end(),
                   begin_index);
 
-        _time_slots.set_activity_at_indices(session.activity, copied_session_indices);
+        _time_slots.set_activity_at_indices(session.time_slots.front().activity, copied_session_indices);
 
         commit_to_history();
     }
@@ -512,6 +549,8 @@ namespace stg {
     void strategy::copy_slots(time_slot_index_t from_index,
                               time_slot_index_t till_index,
                               time_slot_index_t destination_index) {
+        auto timing = instrumentation::scope("strategy::copy_slots");
+
         _time_slots.copy_slots(from_index, till_index, destination_index);
 
         commit_to_history();
@@ -520,11 +559,15 @@ namespace stg {
 #pragma mark - History
 
     void strategy::commit_to_history() {
+        auto timing = instrumentation::scope("strategy::commit_to_history");
+
         if (history.commit(make_history_entry()))
             on_change_event();
     }
 
     void strategy::undo() {
+        auto timing = instrumentation::scope("strategy::undo");
+
         auto history_entry = history.undo();
         if (history_entry) {
             apply_history_entry(history_entry);
@@ -534,6 +577,8 @@ namespace stg {
     }
 
     void strategy::redo() {
+        auto timing = instrumentation::scope("strategy::redo");
+
         auto history_entry = history.redo();
         if (history_entry) {
             apply_history_entry(history_entry);
@@ -559,7 +604,10 @@ namespace stg {
     }
 
     auto strategy::make_history_entry() -> strategy_history::entry {
-        return strategy_history::entry{_activities.data(), _time_slots.data()};
+        return strategy_history::entry{_activities.snapshot(),
+                                       _time_slots.snapshot(),
+                                       _activities.version(),
+                                       _activities.content_hash()};
     }
 
     void strategy::apply_history_entry(const std::optional<strategy_history::entry> &history_entry) {
@@ -573,6 +621,8 @@ namespace stg {
 #pragma mark - Handling Sate Changes
 
     void strategy::time_slots_changed() {
+        auto timing = instrumentation::scope("strategy::time_slots_changed");
+
         _sessions.recalculate(_time_slots);
     }
 
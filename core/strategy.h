@@ -53,8 +53,9 @@ namespace stg {
                           duration_t time_slot_duration_t = defaults::time_slot_duration,
                           size_t number_of_time_slots = defaults::number_of_time_slots);
 
+        // Time slots refer to activities by the snapshot's handles.
         strategy(const time_slots_state::data_t &time_slots,
-                 const activity_list::data_t &activities);
+                 const activity_list::snapshot_t &activities);
 
         strategy(const strategy &other);
 
@@ -123,7 +124,12 @@ namespace stg {
         void fill_time_slots(time_slot_index_t from_index, time_slot_index_t till_index);
         void end_resizing();
 
+        // While dragging, the model stays intact and the proposed layout
+        // is available as drag preview, which is empty otherwise.
+        // Session indices passed to drag_session() refer to the preview.
+        // Dragged layout is committed to the model in end_dragging().
         auto is_dragging() const -> bool;
+        auto drag_preview() const -> const sessions_list &;
         void begin_dragging(session_index_t session_index);
         auto drag_session(session_index_t session_index, int distance) -> sessions_list::index_t;
         void end_dragging();
@@ -151,6 +157,11 @@ namespace stg {
         activity_list _activities;
         time_slots_state _time_slots;
         sessions_list _sessions;
+        sessions_list _drag_preview;
+
+        // Dragging works on this copy of time slots,
+        // which is kept between drags to reuse its storage.
+        time_slots_state _drag_time_slots = time_slots_state(0, 0, 0);
         strategy_history history;
 
         std::unique_ptr<drag_operation> current_drag_operation = nullptr;
@@ -159,6 +170,8 @@ namespace stg {
         void time_slots_changed();
         void setup_time_slots_callback();
 
+        void reset_drag_preview();
+
         // current session, may be empty
         auto get_current_session() const -> const session *;
 
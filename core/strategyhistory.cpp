@@ -58,12 +58,12 @@ bool stg::strategy_history::has_prevoius_activities_state() {
     if (!has_prevoius_state())
         return false;
 
-    return current_state.activities != undo_stack.back().activities;
+    return *current_state.activities != *undo_stack.back().activities;
 }
 
 bool stg::strategy_history::has_next_activities_state() {
     if (!has_next_state())
         return false;
 
-    return current_state.activities != redo_stack.back().activities;
+    return *current_state.activities != *redo_stack.back().activities;
 }
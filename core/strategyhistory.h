@@ -15,17 +15,26 @@ namespace stg {
     class strategy_history {
     public:
         struct entry {
-            activity_list::data_t activities;
-            time_slots_state::data_t time_slots;
+            activity_list::snapshot_t activities;
+            time_slots_snapshot time_slots;
+
+            activity_list::version_t activities_version = 0;
+            content_hash_t activities_hash = 0;
 
             friend auto operator==(const entry &lhs, const entry &rhs) -> bool {
-                auto activities_are_equal = std::equal(lhs.activities.begin(),
-                                                       lhs.activities.end(),
-                                                       rhs.activities.begin(),
-                                                       rhs.activities.end(),
-                                                       [](const auto &l, const auto &r) {
-                                                           return *l == *r;
-                                                       });
+                if (lhs.activities_hash != rhs.activities_hash ||
+                    lhs.time_slots.content_hash() != rhs.time_slots.content_hash())
+                    return false;
+
+                // Equal versions mean nothing has changed in between.
+                if (lhs.activities_version != 0 &&
+                    lhs.activities_version == rhs.activities_version &&
+                    lhs.time_slots.version() != 0 &&
+                    lhs.time_slots.version() == rhs.time_slots.version())
+                    return true;
+
+                auto activities_are_equal = lhs.activities == rhs.activities ||
+                                            *lhs.activities == *rhs.activities;
                 return activities_are_equal &&
                        lhs.time_slots == rhs.time_slots;
             }
@@ -0,0 +1,82 @@
+#include <cmath>
+#include <unordered_map>
+
+#include <catch2/catch.hpp>
+
+#include "actioncenter.h"
+#include "strategy.h"
+#include "time_utils.h"
+
+TEST_CASE("Action center wakeups", "[action_center]") {
+    using namespace stg;
+
+    // Timer backend mock
+    std::unordered_map<size_t, std::function<void()>> timers;
+    size_t next_timer_id = 0;
+    timer::seconds last_scheduled_interval = 0;
+
+    timer::backend::set_scheduler([&](auto seconds, auto callback) {
+        auto *timer_id = (void *) next_timer_id++;
+        timers[(size_t) timer_id] = [=]() { callback(timer_id); };
+        last_scheduled_interval = seconds;
+
+        return timer_id;
+    });
+
+    timer::backend::set_invalidator([&timers](void *timer_impl_ptr) {
+        timers.erase((size_t) timer_impl_ptr);
+    });
+
+    // Time source mock
+    auto current_seconds = 0u;
+    time_utils::set_time_source([&current_seconds]() {
+        return current_seconds;
+    });
+
+    auto strategy = stg::strategy();
+    strategy.add_activity(activity("Some"));
+    strategy.place_activity(0, {1});
+
+    auto first_session_seconds = strategy.begin_time() * 60;
+    auto second_session_seconds = strategy.sessions()[1].begin_time() * 60;
+
+    SECTION("next session boundary") {
+        current_seconds = second_session_seconds - 40;
+        auto action_center = stg::action_center(
+            strategy, [] { return 0.01; }, [] { return rect(); });
+
+        REQUIRE(action_center.seconds_until_next_wakeup() == Approx(40));
+        REQUIRE(last_scheduled_interval == Approx(40));
+    }
+
+    SECTION("next minute rollover") {
+        current_seconds = second_session_seconds + 15;
+        auto action_center = stg::action_center(
+            strategy, [] { return 0.01; }, [] { return rect(); });
+
+        REQUIRE(action_center.seconds_until_next_wakeup() == Approx(45));
+    }
+
+    SECTION("next current time marker device pixel") {
+        current_seconds = first_session_seconds + 100;
+        auto action_center = stg::action_center(
+            strategy, [] { return 35; }, [] { return rect(); }, [] { return 2; });
+
+        auto seconds_per_pixel = strategy.duration() * 60.0 / (strategy.number_of_time_slots() * 35 * 2);
+        auto expected_interval = std::ceil(100 / seconds_per_pixel) * seconds_per_pixel - 100;
+
+        REQUIRE(action_center.seconds_until_next_wakeup() == Approx(expected_interval));
+    }
+
+    SECTION("re-arms when sessions change") {
+        current_seconds = second_session_seconds - 100;
+        auto action_center = stg::action_center(
+            strategy, [] { return 0.01; }, [] { return rect(); });
+
+        REQUIRE(last_scheduled_interval == Approx(100));
+
+        strategy.make_empty_at({1});
+
+        REQUIRE(last_scheduled_interval == Approx(action_center::max_wakeup_interval));
+    }
+}
@@ -0,0 +1,193 @@
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "strategy.h"
+
+TEST_CASE("Activity list search", "[activities][search]") {
+    auto strategy = stg::strategy();
+
+    strategy.add_activity(stg::activity("Reading"));
+    strategy.add_activity(stg::activity("Reading news"));
+    strategy.add_activity(stg::activity("Running"));
+    strategy.add_activity(stg::activity("Omega"));
+
+    const auto &activities = strategy.activities();
+
+    auto filtered_names = [&activities]() {
+        auto names = std::vector<std::string>();
+        for (auto id : activities.filtered())
+            names.push_back(activities.get(id)->name());
+
+        return names;
+    };
+
+    SECTION("empty query shows all activities") {
+        REQUIRE_FALSE(activities.search("  "));
+        REQUIRE(activities.filtered().size() == 4);
+    }
+
+    SECTION("query is case-folded") {
+        REQUIRE(activities.search("READ"));
+        REQUIRE(filtered_names() == std::vector<std::string>{"Reading", "Reading news"});
+
+        activities.search("oMEGA");
+        REQUIRE(filtered_names() == std::vector<std::string>{"Omega"});
+    }
+
+    SECTION("extending and shortening the query") {
+        activities.search("r");
+        REQUIRE(activities.filtered().size() == 3);
+
+        REQUIRE(activities.search("re"));
+        REQUIRE(filtered_names() == std::vector<std::string>{"Reading", "Reading news"});
+
+        REQUIRE(activities.search("rex"));
+        REQUIRE(activities.filtered().empty());
+
+        REQUIRE(activities.search("r"));
+        REQUIRE(activities.filtered().size() == 3);
+
+        REQUIRE_FALSE(activities.search("r "));
+    }
+
+    SECTION("results follow activity changes") {
+        activities.search("read");
+
+        strategy.add_activity(stg::activity("Read later"));
+        REQUIRE(activities.filtered().size() == 3);
+
+        strategy.edit_activity(0, stg::activity("Writing"));
+        REQUIRE(filtered_names() == std::vector<std::string>{"Read later", "Reading news"});
+
+        activities.search("reading");
+        REQUIRE(filtered_names() == std::vector<std::string>{"Reading news"});
+
+        strategy.delete_activity(1);
+        REQUIRE(activities.filtered().empty());
+
+        strategy.undo();
+        REQUIRE(filtered_names() == std::vector<std::string>{"Reading news"});
+    }
+}
+
+TEST_CASE("Activity list ranked search", "[activities][search]") {
+    auto names = std::vector<std::string>{"Gardening",
+                                          "Go running",
+                                          "Reading",
+                                          "Grading",
+                                          "Run"};
+
+    auto activities = std::vector<stg::activity>();
+    for (auto &name : names)
+        activities.emplace_back(name);
+
+    const auto list = stg::activity_list(activities);
+
+    auto filtered_names = [&list]() {
+        auto names = std::vector<std::string>();
+        for (auto id : list.filtered())
+            names.push_back(list.get(id)->name());
+
+        return names;
+    };
+
+    SECTION("prefix, word start, substring, subsequence") {
+        list.search("r");
+        REQUIRE(filtered_names() == std::vector<std::string>{"Run",
+                                                             "Reading",
+                                                             "Go running",
+                                                             "Grading",
+                                                             "Gardening"});
+
+        list.search("run");
+        REQUIRE(filtered_names() == std::vector<std::string>{"Run", "Go running"});
+
+        list.search("gng");
+        REQUIRE(filtered_names() == std::vector<std::string>{"Grading",
+                                                             "Gardening",
+                                                             "Go running"});
+    }
+
+    SECTION("equal ranks keep list order") {
+        list.search("rdng");
+        REQUIRE(filtered_names() == std::vector<std::string>{"Grading",
+                                                             "Gardening",
+                                                             "Reading"});
+    }
+
+    SECTION("shorter prefix matches go first") {
+        list.search("gr");
+        REQUIRE(filtered_names().front() == "Grading");
+    }
+
+    SECTION("narrowed results are ranked the same way") {
+        list.search("g");
+        list.search("gr");
+        auto narrowed = filtered_names();
+
+        list.search("");
+        list.search("gr");
+
+        REQUIRE(filtered_names() == narrowed);
+    }
+}
+
+// Excluded from default runs, since the bound holds for optimized builds only.
+TEST_CASE("Activity list search benchmark", "[activities][search][.benchmark]") {
+    using namespace std::chrono;
+
+    constexpr auto activities_count = 10000;
+
+    auto words = std::vector<std::string>{"reading", "writing", "running", "cooking",
+                                          "meeting", "planning", "review", "gym",
+                                          "email", "lunch", "call", "design"};
+
+    auto activities = std::vector<stg::activity>();
+    activities.reserve(activities_count);
+
+    for (auto i = 0; i < activities_count; i++) {
+        auto name = words[i % words.size()] + " " +
+                    words[(i / words.size()) % words.size()] + " " +
+                    std::to_string(i);
+
+        activities.emplace_back(name);
+    }
+
+    const auto list = stg::activity_list(activities);
+
+    auto queries = std::vector<std::string>{"r", "re", "rev", "review", "review 1",
+                                            "cll", "plnng", "gym lunch", "design 1234", "xyz"};
+
+    auto rounds_count = 10;
+    auto elapsed_time = steady_clock::duration::zero();
+
+    for (auto round = 0; round < rounds_count; round++) {
+        for (auto &query : queries) {
+            // Only the query itself is timed, resetting the filter isn't.
+            list.search("");
+
+            auto start_time = steady_clock::now();
+            list.search(query);
+            elapsed_time += steady_clock::now() - start_time;
+        }
+    }
+
+    auto elapsed_microseconds = duration_cast<microseconds>(elapsed_time).count();
+    auto mean_query_microseconds = (double) elapsed_microseconds / (rounds_count * queries.size());
+
+    WARN("searched " << activities_count << " activities, "
+                     << "mean query time " << mean_query_microseconds << " us");
+
+    list.search("review 1");
+    REQUIRE(!list.filtered().empty());
+    REQUIRE(list.get(list.filtered().front())->name().find("review 1") != std::string::npos);
+
+    list.search("xyz");
+    REQUIRE(list.filtered().empty());
+
+    // Sub-millisecond over ten thousand activities.
+    REQUIRE(mean_query_microseconds < 1000);
+}
@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include <catch2/catch.hpp>
+
+#include "instrumentation.h"
+#include "strategy.h"
+
+TEST_CASE("Instrumentation", "[instrumentation]") {
+    using namespace stg;
+
+    instrumentation::reset();
+
+    SECTION("disabled instrumentation records nothing") {
+        instrumentation::set_enabled(false);
+
+        {
+            auto timing = instrumentation::scope("section");
+        }
+
+        instrumentation::record("section", 1);
+
+        REQUIRE(instrumentation::summaries().empty());
+    }
+
+    SECTION("percentiles") {
+        instrumentation::set_enabled(true);
+
+        for (auto i = 1; i <= 100; i++)
+            instrumentation::record("section", i);
+
+        auto summaries = instrumentation::summaries();
+
+        REQUIRE(summaries.size() == 1);
+        REQUIRE(summaries[0].name == "section");
+        REQUIRE(summaries[0].samples_count == 100);
+        REQUIRE(summaries[0].p50 == 50);
+        REQUIRE(summaries[0].p99 == 99);
+        REQUIRE(summaries[0].max == 100);
+    }
+
+    SECTION("percentiles are calculated over the latest samples") {
+        instrumentation::set_enabled(true);
+
+        for (auto i = 0; i < instrumentation::window_size; i++)
+            instrumentation::record("section", 100);
+
+        for (auto i = 0; i < instrumentation::window_size; i++)
+            instrumentation::record("section", 1);
+
+        auto summary = instrumentation::summaries()[0];
+
+        REQUIRE(summary.samples_count == 2 * instrumentation::window_size);
+        REQUIRE(summary.max == 1);
+    }
+
+    SECTION("strategy mutations are measured") {
+        instrumentation::set_enabled(true);
+
+        auto strategy = stg::strategy();
+        strategy.add_activity(activity("Some"));
+        strategy.place_activity(0, {0, 1});
+
+        auto summaries = instrumentation::summaries();
+        auto has_summary = [&summaries](const std::string &name) {
+            return std::any_of(summaries.begin(), summaries.end(),
+                               [&name](auto &summary) { return summary.name == name; });
+        };
+
+        REQUIRE(has_summary("strategy::add_activity"));
+        REQUIRE(has_summary("strategy::place_activity"));
+        REQUIRE(has_summary("strategy::time_slots_changed"));
+    }
+
+    SECTION("writing to file") {
+        instrumentation::set_enabled(true);
+        instrumentation::record("section", 2);
+
+        auto path = std::string("instrumentation_test.tsv");
+        instrumentation::write_to_file(path);
+
+        auto file = std::ifstream(path);
+        auto header = std::string();
+        auto line = std::string();
+
+        std::getline(file, header);
+        std::getline(file, line);
+
+        REQUIRE(header == "section\tsamples\tp50_ms\tp99_ms\tmax_ms");
+        REQUIRE(line == "section\t1\t2\t2\t2");
+
+        file.close();
+        std::remove(path.c_str());
+    }
+
+    instrumentation::set_enabled(false);
+    instrumentation::reset();
+}
@@ -31,7 +31,7 @@ void test_strategy_file(const std::string &filename) {
     REQUIRE(strategy->time_slots()[0].begin_time == 370);
     REQUIRE(strategy->time_slots()[0].duration == 10);
     REQUIRE(strategy->time_slots()[0].activity == stg::strategy::no_activity);
-    REQUIRE(strategy->time_slots()[2].activity == strategy->activities().at(0));
+    REQUIRE(strategy->time_slots()[2].activity == strategy->activities().id_at(0));
 
     REQUIRE(strategy->activities().size() == 3);
     REQUIRE(strategy->activities()[0].name() == "Exercise");
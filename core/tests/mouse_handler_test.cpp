@@ -0,0 +1,196 @@
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "mousehandler.h"
+#include "selection.h"
+#include "simulated_clock.h"
+#include "strategy.h"
+
+TEST_CASE("Mouse handler move coalescing", "[mouse_handler]") {
+    using namespace stg;
+
+    auto clock = test::simulated_clock();
+
+    auto strategy = stg::strategy();
+    auto selection = stg::selection(strategy);
+
+    strategy.add_activity(activity("Some"));
+    strategy.place_activity(0, {2});
+
+    constexpr gfloat slot_height = 40;
+    auto handler = mouse_handler(
+        strategy,
+        selection,
+        [] { return slot_height; },
+        [] { return rect(0, 0, 100, 1000); });
+
+    auto cursors = std::vector<mouse_handler::cursor>();
+    handler.on_cursor_change = [&](auto cursor) { cursors.push_back(cursor); };
+
+    // Slot 2 spans from 100 to 140.
+    auto empty_slot_position = point(10, 300);
+    auto session_position = point(10, 120);
+
+    SECTION("every move is processed by default") {
+        handler.mouse_move(mouse_event(empty_slot_position, 0));
+        handler.mouse_move(mouse_event(session_position, 0));
+
+        REQUIRE(handler.move_statistics().received_count == 2);
+        REQUIRE(handler.move_statistics().processed_count == 2);
+        REQUIRE(handler.move_statistics().coalesced_count == 0);
+        REQUIRE(cursors == std::vector{mouse_handler::cursor::open_hand});
+    }
+
+    SECTION("only the latest move of a frame is processed") {
+        handler.settings.coalesces_mouse_moves = true;
+
+        for (auto i = 0; i < 4; i++)
+            handler.mouse_move(mouse_event(empty_slot_position, 0));
+
+        handler.mouse_move(mouse_event(session_position, 0));
+
+        REQUIRE(handler.move_statistics().processed_count == 0);
+        REQUIRE(cursors.empty());
+
+        clock.advance_by(handler.settings.frame_duration);
+
+        REQUIRE(handler.move_statistics().received_count == 5);
+        REQUIRE(handler.move_statistics().processed_count == 1);
+        REQUIRE(handler.move_statistics().coalesced_count == 4);
+        REQUIRE(cursors == std::vector{mouse_handler::cursor::open_hand});
+        REQUIRE(clock.active_timers_count() == 0);
+
+        SECTION("next frame starts over") {
+            handler.mouse_move(mouse_event(empty_slot_position, 0));
+            clock.advance_by(handler.settings.frame_duration);
+
+            REQUIRE(handler.move_statistics().processed_count == 2);
+            REQUIRE(cursors.back() == mouse_handler::cursor::pointer);
+        }
+    }
+
+    SECTION("pending move is processed before other events") {
+        handler.settings.coalesces_mouse_moves = true;
+
+        handler.mouse_move(mouse_event(session_position, 0));
+        handler.mouse_release(mouse_event(session_position, 0));
+
+        REQUIRE(handler.move_statistics().processed_count == 1);
+        REQUIRE(cursors.front() == mouse_handler::cursor::open_hand);
+        REQUIRE(clock.active_timers_count() == 0);
+
+        clock.advance_by(handler.settings.frame_duration);
+
+        REQUIRE(handler.move_statistics().processed_count == 1);
+    }
+}
+
+TEST_CASE("Mouse handler autoscroll", "[mouse_handler][autoscroll]") {
+    using namespace stg;
+
+    auto clock = test::simulated_clock();
+
+    auto strategy = stg::strategy();
+    auto selection = stg::selection(strategy);
+
+    strategy.add_activity(activity("Some"));
+    strategy.place_activity(0, {2});
+
+    constexpr gfloat slot_height = 40;
+    constexpr gfloat viewport_height = 400;
+    gfloat viewport_top = 0;
+
+    auto handler = mouse_handler(
+        strategy,
+        selection,
+        [] { return slot_height; },
+        [&] { return rect(0, viewport_top, 100, viewport_height); });
+
+    // Pointer keeps its position in the viewport, while the slotboard scrolls under it.
+    auto pointer_y = viewport_height - handler.settings.autoscroll_zone_size / 2;
+    auto scroll_increments = std::vector<gfloat>();
+
+    handler.on_auto_scroll_frame = [&](gfloat increment) {
+        scroll_increments.push_back(increment);
+        viewport_top += increment;
+
+        return point(10, viewport_top + pointer_y);
+    };
+
+    auto preview_changes_count = 0;
+    strategy.drag_preview().add_on_change_callback([&] { preview_changes_count++; });
+
+    handler.mouse_press(mouse_event(point(10, 120)));
+    handler.mouse_move(mouse_event(point(10, pointer_y)));
+
+    auto frame_duration = handler.settings.frame_duration;
+
+    SECTION("speed is proportional to depth in the autoscroll zone") {
+        clock.advance_by(frame_duration);
+
+        auto expected_increment = handler.settings.autoscroll_max_speed * 0.5 * frame_duration;
+        REQUIRE(scroll_increments.size() == 1);
+        REQUIRE(scroll_increments.front() == Approx(expected_increment));
+
+        pointer_y = viewport_height;
+        handler.mouse_move(mouse_event(point(10, viewport_top + pointer_y)));
+        clock.advance_by(frame_duration);
+
+        REQUIRE(scroll_increments.back() == Approx(2 * expected_increment));
+    }
+
+    SECTION("moves are batched into autoscroll frames") {
+        auto processed_count = handler.move_statistics().processed_count;
+
+        for (auto frame = 0; frame < 10; frame++) {
+            preview_changes_count = 0;
+
+            for (auto i = 0; i < 3; i++)
+                handler.mouse_move(mouse_event(point(10, viewport_top + pointer_y)));
+
+            clock.advance_by(frame_duration);
+
+            REQUIRE(preview_changes_count <= 1);
+        }
+
+        REQUIRE(handler.move_statistics().processed_count == processed_count + 10);
+        REQUIRE(handler.move_statistics().coalesced_count == 30);
+    }
+
+    SECTION("leaving the zone stops autoscroll") {
+        clock.advance_by(frame_duration);
+
+        pointer_y = viewport_height / 2;
+        handler.mouse_move(mouse_event(point(10, viewport_top + pointer_y)));
+        clock.advance_by(frame_duration);
+
+        REQUIRE(scroll_increments.size() == 1);
+
+        clock.advance_by(10 * frame_duration);
+
+        REQUIRE(scroll_increments.size() == 1);
+        REQUIRE(clock.active_timers_count() == 0);
+    }
+
+    handler.mouse_release(mouse_event(point(10, viewport_top + pointer_y)));
+}
+
+TEST_CASE("Sessions list hit testing", "[mouse_handler][sessions]") {
+    auto strategy = stg::strategy();
+
+    strategy.add_activity(stg::activity("Some"));
+    strategy.place_activity(0, {2, 3});
+
+    const auto &sessions = strategy.sessions();
+
+    REQUIRE(sessions.session_index_for_time_slot_index(0) == 0);
+    REQUIRE(sessions.session_index_for_time_slot_index(1) == 0);
+    REQUIRE(sessions.session_index_for_time_slot_index(2) == 1);
+    REQUIRE(sessions.session_index_for_time_slot_index(3) == 1);
+    REQUIRE(sessions.session_index_for_time_slot_index(4) == 2);
+    REQUIRE(sessions.session_index_for_time_slot_index(strategy.number_of_time_slots() - 1) == 2);
+
+    REQUIRE(sessions.session_index_for_time_slot_index(-1) == -1);
+    REQUIRE(sessions.session_index_for_time_slot_index(strategy.number_of_time_slots()) == -1);
+}
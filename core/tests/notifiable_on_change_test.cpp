@@ -0,0 +1,95 @@
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "notifiableonchange.h"
+#include "strategy.h"
+
+TEST_CASE("Notifiable on change deferred dispatch", "[notifiable]") {
+    using namespace stg;
+    using dispatch_mode = notifiable_on_change::dispatch_mode;
+
+    // Event loop mock
+    std::vector<std::function<void()>> posted;
+    notifiable_on_change::set_post_hook([&posted](std::function<void()> fn) {
+        posted.push_back(std::move(fn));
+    });
+
+    auto run_event_loop_turn = [&posted] {
+        auto functions = std::move(posted);
+        posted.clear();
+
+        for (auto &fn : functions)
+            fn();
+    };
+
+    notifiable_on_change::reset_statistics();
+
+    auto strategy = stg::strategy();
+    strategy.add_activity(activity("Some"));
+
+    auto sessions_callbacks_count = 0;
+    strategy.sessions().add_on_change_callback([&] { sessions_callbacks_count++; });
+
+    SECTION("immediate mode invokes callbacks on every change") {
+        strategy.place_activity(0, {0});
+        strategy.place_activity(0, {1});
+
+        REQUIRE(sessions_callbacks_count == 2);
+        REQUIRE(posted.empty());
+    }
+
+    SECTION("deferred mode coalesces changes until the next turn") {
+        strategy.sessions().set_dispatch_mode(dispatch_mode::deferred);
+
+        strategy.place_activity(0, {0});
+        strategy.place_activity(0, {1});
+        strategy.place_activity(0, {2});
+
+        REQUIRE(sessions_callbacks_count == 0);
+        REQUIRE(posted.size() == 1);
+
+        run_event_loop_turn();
+
+        REQUIRE(sessions_callbacks_count == 1);
+        REQUIRE(notifiable_on_change::statistics().suppressed_callbacks_count == 2);
+
+        strategy.place_activity(0, {3});
+        run_event_loop_turn();
+
+        REQUIRE(sessions_callbacks_count == 2);
+    }
+
+    SECTION("model stays consistent in deferred mode") {
+        strategy.set_dispatch_mode(dispatch_mode::deferred);
+        strategy.sessions().set_dispatch_mode(dispatch_mode::deferred);
+
+        strategy.place_activity(0, {0, 1});
+
+        // Time slots are immediate, so sessions are already recalculated.
+        REQUIRE(strategy.sessions()[0].activity != stg::strategy::no_activity);
+        REQUIRE(strategy.sessions()[0].length() == 2);
+    }
+
+    SECTION("destroyed notifiable is not flushed") {
+        auto callbacks_count = 0;
+
+        {
+            auto other_strategy = stg::strategy();
+            other_strategy.set_dispatch_mode(dispatch_mode::deferred);
+            other_strategy.add_on_change_callback([&] { callbacks_count++; });
+
+            other_strategy.add_activity(activity("Some"));
+            other_strategy.place_activity(0, {0});
+        }
+
+        run_event_loop_turn();
+
+        REQUIRE(callbacks_count == 0);
+    }
+
+    notifiable_on_change::flush_pending();
+    notifiable_on_change::set_post_hook(nullptr);
+}
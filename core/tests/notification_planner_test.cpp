@@ -0,0 +1,100 @@
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "notificationplanner.h"
+#include "notifier.h"
+#include "spscqueue.h"
+#include "strategy.h"
+
+TEST_CASE("SPSC queue", "[notifier][planner]") {
+    auto queue = stg::spsc_queue<int, 4>();
+
+    REQUIRE(queue.empty());
+    REQUIRE(queue.try_push(1));
+    REQUIRE(queue.try_push(2));
+    REQUIRE(queue.try_push(3));
+
+    // One slot is always kept empty.
+    REQUIRE_FALSE(queue.try_push(4));
+
+    REQUIRE(*queue.try_pop() == 1);
+    REQUIRE(queue.try_push(4));
+
+    REQUIRE(*queue.try_pop() == 2);
+    REQUIRE(*queue.try_pop() == 3);
+    REQUIRE(*queue.try_pop() == 4);
+    REQUIRE(queue.try_pop() == std::nullopt);
+}
+
+TEST_CASE("Notification planner", "[notifier][planner]") {
+    using namespace stg;
+    using namespace user_notifications;
+
+    // Main thread dispatcher mock
+    std::mutex dispatched_mutex;
+    std::vector<std::function<void()>> dispatched;
+
+    notification_planner::backend::set_main_thread_dispatcher([&](std::function<void()> fn) {
+        auto lock = std::lock_guard(dispatched_mutex);
+        dispatched.push_back(std::move(fn));
+    });
+
+    // Notifier backend mock
+    std::vector<notifier::notifications_list> scheduled_lists;
+    backend::set_scheduler([&](const auto &notifications) {
+        scheduled_lists.push_back(notifications);
+    });
+
+    backend::set_resetter([](const auto &) {});
+
+    auto strategy = stg::strategy();
+    strategy.add_activity(activity("Some"));
+
+    SECTION("plans off the main thread") {
+        auto notifier = stg::notifier(strategy);
+
+        // Initial scheduling is synchronous.
+        REQUIRE(scheduled_lists.size() == 1);
+
+        strategy.place_activity(0, {1});
+
+        REQUIRE(scheduled_lists.size() == 1);
+
+        notification_planner::shared().wait_until_idle();
+
+        REQUIRE(scheduled_lists.size() == 2);
+        REQUIRE(scheduled_lists.back().size() == 6);
+    }
+
+    SECTION("delivers only the latest plan") {
+        auto notifier = stg::notifier(strategy);
+
+        strategy.place_activity(0, {1});
+        strategy.place_activity(0, {5});
+        strategy.make_empty_at({1});
+
+        notification_planner::shared().wait_until_idle();
+
+        REQUIRE(scheduled_lists.size() == 2);
+        REQUIRE(scheduled_lists.back().size() == 6);
+        REQUIRE(notifier.scheduled_identifiers().size() == 6);
+    }
+
+    SECTION("finishes planning on destruction") {
+        {
+            auto notifier = stg::notifier(strategy);
+            strategy.place_activity(0, {1});
+        }
+
+        REQUIRE(scheduled_lists.size() == 2);
+    }
+
+    notification_planner::shared().wait_until_idle();
+    notification_planner::backend::set_main_thread_dispatcher(nullptr);
+
+    backend::set_scheduler(nullptr);
+    backend::set_resetter(nullptr);
+}
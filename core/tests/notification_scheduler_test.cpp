@@ -0,0 +1,148 @@
+#include <unordered_map>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "notificationscheduler.h"
+#include "notifier.h"
+#include "persistent.h"
+#include "strategy.h"
+#include "time_utils.h"
+
+TEST_CASE("Notification scheduler", "[notifier][scheduler]") {
+    using namespace stg;
+    using namespace user_notifications;
+
+    // Timer backend mock
+    std::unordered_map<size_t, std::function<void()>> timers;
+    size_t next_timer_id = 0;
+
+    timer::backend::set_scheduler([&](auto, auto callback) {
+        auto *timer_id = (void *) next_timer_id++;
+        timers[(size_t) timer_id] = [=]() { callback(timer_id); };
+
+        return timer_id;
+    });
+
+    timer::backend::set_invalidator([&timers](void *timer_impl_ptr) {
+        timers.erase((size_t) timer_impl_ptr);
+    });
+
+    // Time source mock
+    auto current_seconds = 0u;
+    time_utils::set_time_source([&current_seconds]() {
+        return current_seconds;
+    });
+
+    // Persistent storage mock
+    std::unordered_map<std::string, std::vector<uint8_t>> storage_mock;
+    auto storage_writes_count = 0;
+
+    persistent_storage::backend::set_setter([&](const std::string &key,
+                                                const void *data,
+                                                size_t size) {
+        storage_writes_count++;
+        storage_mock[key] = std::vector<uint8_t>((const uint8_t *) data,
+                                                 (const uint8_t *) data + size);
+    });
+
+    persistent_storage::backend::set_getter([&](const std::string &key,
+                                                const auto &result) {
+        auto it = storage_mock.find(key);
+        result(it != storage_mock.end() ? it->second.data() : nullptr);
+    });
+
+    // Notifier backend mock
+    std::vector<std::string> sent_titles;
+    backend::set_immediate_sender([&sent_titles](const notification &n) {
+        sent_titles.push_back(n.title);
+    });
+
+    backend::set_scheduler(nullptr);
+    backend::set_resetter(nullptr);
+
+    const auto polling_interval = 5;
+
+    auto first_strategy = stg::strategy();
+    first_strategy.add_activity(activity("First"));
+    first_strategy.place_activity(0, {2});
+
+    auto second_strategy = stg::strategy();
+    second_strategy.add_activity(activity("Second"));
+    second_strategy.place_activity(0, {2});
+
+    auto delivery_time = first_strategy.time_slots()[2].begin_time * 60 - notifier::immediate_seconds_interval;
+
+    SECTION("shares a single polling timer") {
+        current_seconds = delivery_time - 1;
+
+        auto first_notifier = stg::notifier(first_strategy);
+        auto second_notifier = stg::notifier(second_strategy);
+
+        first_notifier.start_polling(polling_interval);
+        second_notifier.start_polling(polling_interval);
+
+        REQUIRE(timers.size() == 1);
+
+        current_seconds = delivery_time + 1;
+        timers.begin()->second();
+
+        REQUIRE(sent_titles.size() == 2);
+        REQUIRE(sent_titles[0] != sent_titles[1]);
+
+        // Nothing is due anymore.
+        timers.begin()->second();
+
+        REQUIRE(sent_titles.size() == 2);
+    }
+
+    SECTION("drops deliveries of changed strategy") {
+        current_seconds = delivery_time - 1;
+
+        auto first_notifier = stg::notifier(first_strategy);
+        first_notifier.start_polling(polling_interval);
+
+        first_strategy.make_empty_at({2});
+
+        current_seconds = delivery_time + 1;
+        timers.begin()->second();
+
+        REQUIRE(sent_titles.empty());
+    }
+
+    SECTION("stops polling after the last notifier is gone") {
+        {
+            auto first_notifier = stg::notifier(first_strategy);
+            first_notifier.start_polling(polling_interval);
+
+            {
+                auto second_notifier = stg::notifier(second_strategy);
+                second_notifier.start_polling(polling_interval);
+            }
+
+            REQUIRE(timers.size() == 1);
+        }
+
+        REQUIRE(timers.empty());
+    }
+
+    SECTION("batches identifiers writes") {
+        {
+            auto first_notifier = stg::notifier(first_strategy, "first.stg");
+            auto second_notifier = stg::notifier(second_strategy, "second.stg");
+
+            first_notifier.start_polling(polling_interval);
+
+            REQUIRE(storage_writes_count == 0);
+
+            timers.begin()->second();
+
+            REQUIRE(storage_writes_count == 1);
+        }
+
+        REQUIRE(storage_writes_count == 2);
+        REQUIRE(notifier::active_files().size() == 2);
+    }
+
+    time_utils::set_time_source(nullptr);
+}
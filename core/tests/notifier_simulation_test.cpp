@@ -0,0 +1,166 @@
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "notifier.h"
+#include "simulated_clock.h"
+#include "strategy.h"
+
+namespace {
+    struct simulation_report {
+        size_t planned_count = 0;
+        size_t delivered_count = 0;
+        size_t reschedules_count = 0;
+        size_t timer_fires_count = 0;
+
+        double max_latency = 0;
+        double total_latency = 0;
+
+        auto mean_latency() const -> double {
+            return delivered_count ? total_latency / delivered_count : 0;
+        }
+    };
+
+    // Fills the strategy so that all deliveries are far enough apart
+    // to be sent by separate polls.
+    void fill_daily_strategy(stg::strategy &strategy, unsigned day) {
+        strategy.add_activity(stg::activity("Work"));
+        strategy.add_activity(stg::activity("Rest"));
+
+        auto offset = (int) (day % 4);
+        strategy.place_activity(0, {offset, offset + 1, offset + 2});
+        strategy.place_activity(1, {offset + 8, offset + 9});
+        strategy.place_activity(0, {offset + 20, offset + 21, offset + 22, offset + 23});
+        strategy.place_activity(1, {offset + 40});
+    }
+}
+
+TEST_CASE("Notifier simulated day", "[notifier][simulation]") {
+    using namespace stg;
+    using namespace user_notifications;
+
+    constexpr auto polling_interval = 15;
+    constexpr auto day = test::simulated_clock::seconds_in_day;
+
+    auto clock = test::simulated_clock();
+    auto report = simulation_report();
+
+    // Initial scheduling isn't a reschedule.
+    auto is_polling = false;
+
+    backend::set_immediate_sender([&](const notification &notification) {
+        auto current_seconds = (double) time_utils::current_seconds();
+        auto latency = current_seconds - notification.relative_delivery_time();
+
+        report.delivered_count++;
+        report.total_latency += latency;
+        report.max_latency = std::max(report.max_latency, latency);
+    });
+
+    backend::set_scheduler([&](const auto &notifications) {
+        report.planned_count = notifications.size();
+
+        if (is_polling)
+            report.reschedules_count++;
+    });
+
+    backend::set_resetter([](const auto &) {});
+
+    auto replay_day = [&](unsigned day_index, const std::function<void(stg::strategy &)> &during_day = nullptr) {
+        auto day_start = (double) day_index * day;
+        clock.advance_to(day_start + 1);
+
+        auto strategy = stg::strategy();
+        fill_daily_strategy(strategy, day_index);
+
+        is_polling = false;
+
+        auto notifier = stg::notifier(strategy);
+        notifier.start_polling(polling_interval);
+
+        is_polling = true;
+
+        if (during_day)
+            during_day(strategy);
+
+        clock.advance_to(day_start + day - 1);
+    };
+
+    SECTION("full day") {
+        replay_day(0);
+
+        WARN("delivered " << report.delivered_count << " of " << report.planned_count
+                          << ", mean latency " << report.mean_latency() << " s"
+                          << ", max latency " << report.max_latency << " s"
+                          << ", timer fires " << clock.fired_timers_count());
+
+        REQUIRE(report.delivered_count == report.planned_count);
+        REQUIRE(report.reschedules_count == 0);
+        REQUIRE(report.max_latency < polling_interval);
+
+        // Nothing but a single polling timer wakes up during the day.
+        REQUIRE(clock.fired_timers_count() <= day / polling_interval);
+        REQUIRE(clock.active_timers_count() == 0);
+    }
+
+    SECTION("editing strategy during the day") {
+        replay_day(0, [&](stg::strategy &strategy) {
+            clock.advance_to(12 * 60 * 60);
+            strategy.place_activity(1, {50});
+        });
+
+        WARN("reschedules " << report.reschedules_count
+                            << ", max latency " << report.max_latency << " s");
+
+        REQUIRE(report.reschedules_count == 1);
+        REQUIRE(report.max_latency < polling_interval);
+    }
+
+    SECTION("system time change") {
+        replay_day(0, [&](stg::strategy &) {
+            clock.advance_to(10 * 60 * 60);
+
+            // Wall clock goes an hour back, timers don't notice.
+            clock.shift_wall_clock(-60 * 60);
+        });
+
+        WARN("reschedules " << report.reschedules_count
+                            << ", max latency " << report.max_latency << " s");
+
+        REQUIRE(report.reschedules_count == 1);
+        REQUIRE(report.max_latency < polling_interval);
+    }
+
+    SECTION("year of daily strategies") {
+        using namespace std::chrono;
+
+        auto days_count = 365u;
+        auto total_planned_count = 0u;
+
+        auto start_time = steady_clock::now();
+
+        for (auto day_index = 0u; day_index < days_count; ++day_index) {
+            replay_day(day_index);
+            total_planned_count += report.planned_count;
+        }
+
+        auto elapsed_milliseconds = duration_cast<milliseconds>(steady_clock::now() - start_time).count();
+
+        WARN("replayed " << days_count << " days in " << elapsed_milliseconds << " ms"
+                         << ", delivered " << report.delivered_count << " of " << total_planned_count
+                         << ", mean latency " << report.mean_latency() << " s"
+                         << ", max latency " << report.max_latency << " s"
+                         << ", timer fires " << clock.fired_timers_count());
+
+        REQUIRE(report.delivered_count == total_planned_count);
+        REQUIRE(report.reschedules_count == 0);
+        REQUIRE(report.max_latency < polling_interval);
+        REQUIRE(clock.fired_timers_count() <= days_count * (day / polling_interval));
+    }
+
+    backend::set_immediate_sender(nullptr);
+    backend::set_scheduler(nullptr);
+    backend::set_resetter(nullptr);
+}
@@ -0,0 +1,127 @@
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "selection.h"
+#include "strategy.h"
+
+TEST_CASE("Selection", "[selection]") {
+    using run = stg::grouped_selection_element;
+
+    auto strategy = stg::strategy();
+    auto selection = stg::selection(strategy);
+
+    auto change_events_count = 0;
+    selection.add_on_change_callback([&] { change_events_count++; });
+
+    SECTION("selecting adjacent slots merges runs") {
+        selection.set_selected_at(2, true);
+        selection.set_selected_at(4, true);
+
+        REQUIRE(selection.grouped() == stg::grouped_selection{run{2, 2}, run{4, 4}});
+        REQUIRE_FALSE(selection.is_continuous());
+
+        selection.set_selected_at(3, true);
+
+        REQUIRE(selection.grouped() == stg::grouped_selection{run{2, 4}});
+        REQUIRE(selection.is_continuous());
+        REQUIRE(selection.size() == 3);
+        REQUIRE(selection.indices() == std::vector<stg::index_t>{2, 3, 4});
+    }
+
+    SECTION("selecting a selected slot doesn't notify") {
+        selection.set_selected_at(2, true);
+        selection.set_selected_at(2, true);
+
+        REQUIRE(change_events_count == 1);
+    }
+
+    SECTION("deselecting splits a run") {
+        selection.fill(1, 5);
+        selection.toggle_at(3);
+
+        REQUIRE(selection.grouped() == stg::grouped_selection{run{1, 2}, run{4, 5}});
+        REQUIRE(selection.size() == 4);
+        REQUIRE_FALSE(selection.has_selected(3));
+
+        selection.toggle_at(1);
+        selection.set_selected_at(5, false);
+
+        REQUIRE(selection.grouped() == stg::grouped_selection{run{2, 2}, run{4, 4}});
+        REQUIRE(selection.indices() == std::vector<stg::index_t>{2, 4});
+    }
+
+    SECTION("fill merges overlapping runs") {
+        selection.fill(2, 3);
+        selection.fill(6, 7);
+        selection.fill(10, 11);
+        selection.fill(5, 3);
+
+        REQUIRE(selection.grouped() == stg::grouped_selection{run{2, 7}, run{10, 11}});
+        REQUIRE(selection.size() == 8);
+        REQUIRE(selection.front() == 2);
+    }
+
+    SECTION("fill clamps to time slots") {
+        selection.fill(-5, 1);
+
+        REQUIRE(selection.grouped() == stg::grouped_selection{run{0, 1}});
+    }
+
+    SECTION("select all and deselect all") {
+        selection.set_selected_at(5, true);
+        selection.select_all();
+
+        auto last_index = (stg::index_t) strategy.number_of_time_slots() - 1;
+
+        REQUIRE(selection.is_all_selected());
+        REQUIRE(selection.grouped() == stg::grouped_selection{run{0, last_index}});
+        REQUIRE(selection.indices().size() == (size_t) strategy.number_of_time_slots());
+
+        selection.deselect_all();
+
+        REQUIRE(selection.empty());
+        REQUIRE(selection.grouped().empty());
+        REQUIRE(selection.indices().empty());
+    }
+
+    SECTION("reset with unsorted indices") {
+        selection.reset_with({7, 1, 2, 6});
+
+        REQUIRE(selection.grouped() == stg::grouped_selection{run{1, 2}, run{6, 7}});
+        REQUIRE(selection.indices() == std::vector<stg::index_t>{1, 2, 6, 7});
+    }
+
+    SECTION("boundaries") {
+        selection.fill(3, 4);
+
+        REQUIRE(selection.is_boundary(3));
+        REQUIRE_FALSE(selection.is_boundary(4));
+        REQUIRE(selection.is_boundary(5));
+        REQUIRE_FALSE(selection.is_boundary(0));
+    }
+
+    SECTION("empty and non-empty slots") {
+        strategy.add_activity(stg::activity("Some"));
+        strategy.place_activity(0, {2});
+
+        selection.fill(1, 2);
+        REQUIRE_FALSE(selection.only_empty_selected());
+        REQUIRE_FALSE(selection.only_non_empty_selected());
+
+        selection.toggle_at(1);
+        REQUIRE(selection.only_non_empty_selected());
+    }
+
+    SECTION("slots that are gone are dropped") {
+        auto last_index = (stg::index_t) strategy.number_of_time_slots() - 1;
+        selection.fill(last_index - 3, last_index);
+
+        strategy.set_end_time(strategy.end_time() - 2 * strategy.time_slot_duration());
+
+        selection.set_selected_at(0, true);
+
+        REQUIRE(selection.grouped() == stg::grouped_selection{run{0, 0}, run{last_index - 3, last_index - 2}});
+        REQUIRE(selection.size() == 3);
+    }
+}
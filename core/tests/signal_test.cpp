@@ -0,0 +1,115 @@
+#include <memory>
+#include <optional>
+
+#include <catch2/catch.hpp>
+
+#include "stgsignal.h"
+#include "strategy.h"
+
+TEST_CASE("Signal", "[signal]") {
+    using namespace stg;
+
+    auto signal = stg::signal<int>();
+    auto sum = 0;
+
+    SECTION("scoped connection disconnects on destruction") {
+        {
+            auto connection = scoped_connection(signal.connect([&](int value) { sum += value; }));
+            signal(1);
+
+            REQUIRE(connection.is_connected());
+        }
+
+        signal(10);
+
+        REQUIRE(sum == 1);
+        REQUIRE(signal.empty());
+    }
+
+    SECTION("plain connection keeps listener connected") {
+        {
+            signal.connect([&](int value) { sum += value; });
+        }
+
+        signal(1);
+
+        REQUIRE(sum == 1);
+        REQUIRE(signal.size() == 1);
+    }
+
+    SECTION("listener can disconnect itself during emission") {
+        auto connection = stg::connection();
+        connection = signal.connect([&](int value) {
+            sum += value;
+            connection.disconnect();
+        });
+
+        signal.connect([&](int value) { sum += 100 * value; });
+
+        signal(1);
+        signal(1);
+
+        REQUIRE(sum == 1 + 100 + 100);
+        REQUIRE(signal.size() == 1);
+        REQUIRE_FALSE(connection.is_connected());
+    }
+
+    SECTION("listener connected during emission is invoked from the next emission") {
+        auto connected = false;
+        signal.connect([&](int) {
+            if (connected)
+                return;
+
+            connected = true;
+            signal.connect([&](int value) { sum += value; });
+        });
+
+        signal(1);
+        REQUIRE(sum == 0);
+
+        signal(1);
+        REQUIRE(sum == 1);
+    }
+
+    SECTION("connection can outlive the signal") {
+        auto connection = std::optional<scoped_connection>();
+
+        {
+            auto other_signal = stg::signal<>();
+            connection.emplace(other_signal.connect([] {}));
+        }
+
+        REQUIRE_FALSE(connection->is_connected());
+        connection.reset();
+    }
+
+    SECTION("model listeners are removable") {
+        auto strategy = stg::strategy();
+        strategy.add_activity(activity("Some"));
+
+        auto callbacks_count = 0;
+        auto ruler_callbacks_count = 0;
+
+        {
+            auto connection = scoped_connection(
+                strategy.sessions().add_on_change_callback([&] { callbacks_count++; }));
+
+            auto ruler_connection = scoped_connection(
+                strategy.time_slots().add_on_ruler_change_callback([&] { ruler_callbacks_count++; }));
+
+            strategy.place_activity(0, {0});
+            strategy.set_begin_time(10 * 60);
+        }
+
+        REQUIRE(callbacks_count == 2);
+        REQUIRE(ruler_callbacks_count > 0);
+
+        auto last_ruler_callbacks_count = ruler_callbacks_count;
+
+        strategy.place_activity(0, {1});
+        strategy.set_begin_time(11 * 60);
+
+        REQUIRE(callbacks_count == 2);
+        REQUIRE(ruler_callbacks_count == last_ruler_callbacks_count);
+    }
+}
@@ -0,0 +1,129 @@
+#ifndef STRATEGR_SIMULATED_CLOCK_H
+#define STRATEGR_SIMULATED_CLOCK_H
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <tuple>
+#include <utility>
+
+#include "time_utils.h"
+#include "timer.h"
+
+namespace stg::test {
+
+    // Drives time_utils time source and stg::timer callbacks from a single virtual clock,
+    // so that hours of run loop time can be replayed in milliseconds.
+    //
+    // Backend timers behave like run loop timers: they fire every duration seconds
+    // until invalidated. Due timers are fired in order of their fire time,
+    // and the virtual clock is moved to each fire time before the callback.
+
+    class simulated_clock {
+    public:
+        using seconds = double;
+
+        static constexpr auto seconds_in_day = 24 * 60 * 60;
+
+        explicit simulated_clock(seconds start_time = 0) : _now(start_time) {
+            time_utils::set_time_source([this] {
+                auto wall_seconds = std::fmod(_now + wall_clock_offset, (seconds) seconds_in_day);
+                if (wall_seconds < 0)
+                    wall_seconds += seconds_in_day;
+
+                return static_cast<time_utils::seconds>(wall_seconds);
+            });
+
+            timer::backend::set_scheduler([this](timer::seconds duration,
+                                                 const timer::backend::scheduler_callback_t &callback) {
+                auto *implementation = reinterpret_cast<void *>(++last_timer_id);
+                timers[last_timer_id] = {duration, callback};
+                due_timers.emplace(fire_key{_now + duration, last_timer_id}, last_timer_id);
+
+                return implementation;
+            });
+
+            timer::backend::set_invalidator([this](void *implementation) {
+                timers.erase(reinterpret_cast<uintptr_t>(implementation));
+            });
+        }
+
+        ~simulated_clock() {
+            time_utils::set_time_source(nullptr);
+            timer::backend::set_scheduler(nullptr);
+            timer::backend::set_invalidator(nullptr);
+        }
+
+        simulated_clock(const simulated_clock &) = delete;
+
+        // Total seconds since the start of the first simulated day.
+        auto now() const -> seconds {
+            return _now;
+        }
+
+        auto fired_timers_count() const -> size_t {
+            return _fired_timers_count;
+        }
+
+        auto active_timers_count() const -> size_t {
+            return timers.size();
+        }
+
+        void advance_to(seconds time) {
+            while (!due_timers.empty() && due_timers.begin()->first.time <= time) {
+                auto [key, timer_id] = *due_timers.begin();
+                due_timers.erase(due_timers.begin());
+
+                auto timer_it = timers.find(timer_id);
+                if (timer_it == timers.end())
+                    continue;
+
+                _now = key.time;
+
+                // Re-arm before firing, so that callback can invalidate the timer.
+                auto [duration, callback] = timer_it->second;
+                due_timers.emplace(fire_key{_now + duration, timer_id}, timer_id);
+
+                _fired_timers_count++;
+                callback(reinterpret_cast<void *>(timer_id));
+            }
+
+            _now = time;
+        }
+
+        void advance_by(seconds duration) {
+            advance_to(_now + duration);
+        }
+
+        // Imitates system time change: time source jumps, but timers keep their schedule.
+        void shift_wall_clock(seconds offset) {
+            wall_clock_offset += offset;
+        }
+
+    private:
+        struct fire_key {
+            seconds time;
+            uintptr_t timer_id;
+
+            friend auto operator<(const fire_key &lhs, const fire_key &rhs) -> bool {
+                return std::tie(lhs.time, lhs.timer_id) < std::tie(rhs.time, rhs.timer_id);
+            }
+        };
+
+        struct timer_record {
+            timer::seconds duration;
+            timer::backend::scheduler_callback_t callback;
+        };
+
+        seconds _now = 0;
+        seconds wall_clock_offset = 0;
+        size_t _fired_timers_count = 0;
+
+        uintptr_t last_timer_id = 0;
+        std::map<uintptr_t, timer_record> timers;
+        std::map<fire_key, uintptr_t> due_timers;
+    };
+}
+
+#endif//STRATEGR_SIMULATED_CLOCK_H
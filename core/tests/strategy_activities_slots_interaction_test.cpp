@@ -26,7 +26,49 @@ TEST_CASE("Strategy activities and slots interaction") {
         strategy.edit_activity(0, stg::activity("Some Edited"));
         const auto &updatedActivity = strategy.activities()[0];
 
-        REQUIRE(strategy.sessions()[0].activity == &updatedActivity);
-        REQUIRE(strategy.sessions()[2].activity == &updatedActivity);
+        REQUIRE(strategy.activities().get(strategy.sessions()[0].activity) == &updatedActivity);
+        REQUIRE(strategy.activities().get(strategy.sessions()[2].activity) == &updatedActivity);
+    }
+
+    SECTION("editing activity keeps its handle in slots") {
+        auto id = strategy.activities().id_at(0);
+        auto time_slots_version = strategy.time_slots().version();
+
+        strategy.edit_activity(0, stg::activity("Some Edited"));
+
+        REQUIRE(strategy.activities().id_at(0) == id);
+        REQUIRE(&strategy.activities()[0] == &activity);
+        REQUIRE(strategy.time_slots().version() == time_slots_version);
+        REQUIRE(strategy.activities().get(strategy.sessions()[0].activity)->name() == "Some Edited");
+    }
+
+    SECTION("deleted activity's handle doesn't resolve, even if its place is reused") {
+        auto id = strategy.activities().id_at(0);
+
+        strategy.delete_activity(0);
+        strategy.add_activity(stg::activity("Some 2"));
+
+        REQUIRE(strategy.activities().id_at(0).index == id.index);
+        REQUIRE(strategy.activities().id_at(0) != id);
+        REQUIRE(strategy.activities().get(id) == nullptr);
+        REQUIRE(strategy.activities().index_of(id) == std::nullopt);
+    }
+
+    SECTION("session kept after its activity is deleted doesn't resolve to another one") {
+        auto session = strategy.sessions()[0];
+
+        strategy.delete_activity(0);
+        strategy.add_activity(stg::activity("Some 2"));
+
+        REQUIRE(session.activity);
+        REQUIRE(strategy.activities().get(session.activity) == nullptr);
+    }
+
+    SECTION("copied strategy resolves handles in its own activities") {
+        auto copy = strategy;
+
+        REQUIRE(copy.time_slots()[0].activity == strategy.time_slots()[0].activity);
+        REQUIRE(copy.sessions()[0].activity == copy.activities().id_at(0));
+        REQUIRE(copy.activities().get(copy.sessions()[0].activity) != &activity);
     }
 }
\ No newline at end of file
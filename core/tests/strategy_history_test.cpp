@@ -84,4 +84,77 @@ TEST_CASE("Strategy history", "[strategy][history]") {
 
         REQUIRE(strategy.sessions()[0].length() == 2);
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Strategy history activities snapshots", "[strategy][history]") {
+    auto strategy = stg::strategy();
+
+    strategy.add_activity(stg::activity("Some 0"));
+    strategy.add_activity(stg::activity("Some 1"));
+    strategy.add_activity(stg::activity("Some 2"));
+
+    SECTION("snapshot is shared until activities change") {
+        auto snapshot = strategy.activities().snapshot();
+
+        strategy.place_activity(0, {0});
+        REQUIRE(strategy.activities().snapshot() == snapshot);
+
+        strategy.edit_activity(0, stg::activity("Edited"));
+        REQUIRE(strategy.activities().snapshot() != snapshot);
+        REQUIRE((*snapshot)[0].activity.name() == "Some 0");
+    }
+
+    SECTION("indices follow dragging and removal") {
+        auto first_activity = strategy.activities().id_at(0);
+        auto last_activity = strategy.activities().id_at(2);
+
+        strategy.drag_activity(0, 2);
+
+        REQUIRE(strategy.activities().index_of(first_activity) == 2);
+        REQUIRE(strategy.activities().index_of(last_activity) == 1);
+
+        strategy.delete_activity(1);
+
+        REQUIRE(strategy.activities().index_of(last_activity) == std::nullopt);
+        REQUIRE(strategy.activities().index_of(first_activity) == 1);
+
+        strategy.undo();
+
+        REQUIRE(strategy.activities().index_of(last_activity) == 1);
+        REQUIRE(strategy.activities().index_of(first_activity) == 2);
+    }
+
+    SECTION("undoing an edit restores the value under the same handle") {
+        strategy.place_activity(1, {0, 1});
+
+        auto id = strategy.activities().id_at(1);
+        const auto *activity = strategy.activities().at(1);
+
+        strategy.edit_activity(1, stg::activity("Edited"));
+        strategy.undo();
+
+        REQUIRE(strategy.activities().at(1) == activity);
+        REQUIRE(activity->name() == "Some 1");
+        REQUIRE(strategy.time_slots()[0].activity == id);
+
+        strategy.redo();
+
+        REQUIRE(strategy.activities().at(1) == activity);
+        REQUIRE(strategy.activities().get(strategy.sessions()[0].activity)->name() == "Edited");
+    }
+
+    SECTION("undoing removal brings the handle back to its slots") {
+        strategy.place_activity(1, {2});
+
+        auto id = strategy.activities().id_at(1);
+
+        strategy.delete_activity(1);
+        REQUIRE(strategy.time_slots()[2].activity == stg::strategy::no_activity);
+
+        strategy.undo();
+
+        REQUIRE(strategy.activities().index_of(id) == 1);
+        REQUIRE(strategy.time_slots()[2].activity == id);
+        REQUIRE(strategy.sessions()[1].activity == strategy.activities().id_at(1));
+    }
+}
@@ -34,4 +34,106 @@ TEST_CASE("Strategy settings", "[strategy][settings]") {
 
         REQUIRE(strategy.number_of_time_slots() == expected_number_of_slots);
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Strategy time grid changes", "[strategy][settings][runs]") {
+    auto strategy = stg::strategy();
+
+    strategy.add_activity(stg::activity("Some 0"));
+    strategy.add_activity(stg::activity("Some 1"));
+
+    strategy.place_activity(0, {1});
+    strategy.place_activity(1, {2, 3});
+    strategy.place_activity(0, {strategy.number_of_time_slots() - 1});
+
+    auto initial_time_slots = strategy.time_slots().data();
+
+    SECTION("changing slot duration back and forth is lossless") {
+        strategy.set_time_slot_duration(20);
+        strategy.set_time_slot_duration(15);
+
+        REQUIRE(strategy.time_slots().data() == initial_time_slots);
+
+        strategy.set_time_slot_duration(60);
+        strategy.set_time_slot_duration(5);
+        strategy.set_time_slot_duration(15);
+
+        REQUIRE(strategy.time_slots().data() == initial_time_slots);
+    }
+
+    SECTION("coarser slots get activities that cover most of their time") {
+        strategy.set_time_slot_duration(30);
+
+        REQUIRE(strategy.time_slots()[0].activity == strategy.activities().id_at(0));
+        REQUIRE(strategy.time_slots()[1].activity == strategy.activities().id_at(1));
+    }
+
+    SECTION("slots hidden by end time come back") {
+        auto end_time = strategy.end_time();
+
+        strategy.set_end_time(end_time - 60);
+        REQUIRE(strategy.number_of_time_slots() == static_cast<int>(initial_time_slots.size()) - 4);
+
+        strategy.set_end_time(end_time);
+        REQUIRE(strategy.time_slots().data() == initial_time_slots);
+    }
+
+    SECTION("slots hidden by begin time come back") {
+        auto begin_time = strategy.begin_time();
+
+        strategy.set_begin_time(begin_time + 60);
+        REQUIRE(strategy.time_slots().first().begin_time == begin_time + 60);
+        REQUIRE(strategy.time_slots().first().activity == stg::strategy::no_activity);
+
+        strategy.set_begin_time(begin_time);
+        REQUIRE(strategy.time_slots().data() == initial_time_slots);
+    }
+
+    SECTION("slots changed on a coarser grid replace their time only") {
+        strategy.set_time_slot_duration(30);
+        strategy.make_empty_at({0});
+        strategy.set_time_slot_duration(15);
+
+        REQUIRE(strategy.time_slots()[1].activity == stg::strategy::no_activity);
+        REQUIRE(strategy.time_slots()[2].activity == strategy.activities().id_at(1));
+        REQUIRE(strategy.time_slots()[3].activity == strategy.activities().id_at(1));
+    }
+
+    SECTION("deleted activities don't come back") {
+        auto end_time = strategy.end_time();
+
+        strategy.set_end_time(end_time - 60);
+        strategy.delete_activity(0);
+        strategy.set_end_time(end_time);
+
+        REQUIRE(strategy.time_slots().last().activity == stg::strategy::no_activity);
+    }
+
+    SECTION("undo keeps runs") {
+        strategy.set_time_slot_duration(20);
+        strategy.set_time_slot_duration(30);
+        strategy.undo();
+        strategy.set_time_slot_duration(15);
+
+        REQUIRE(strategy.time_slots().data() == initial_time_slots);
+    }
+
+    SECTION("history keeps grid changes as the grid and runs") {
+        strategy.set_time_slot_duration(20);
+
+        auto snapshot = strategy.time_slots().snapshot();
+        auto time_slots = strategy.time_slots().data();
+
+        REQUIRE(snapshot.is_projected());
+
+        strategy.set_time_slot_duration(30);
+        strategy.undo();
+
+        REQUIRE(strategy.time_slots().data() == time_slots);
+        REQUIRE(strategy.time_slots().snapshot().runs() == snapshot.runs());
+
+        strategy.undo();
+
+        REQUIRE(strategy.time_slots().data() == initial_time_slots);
+    }
+}
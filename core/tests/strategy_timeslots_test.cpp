@@ -2,10 +2,235 @@
 // Created by Dmitry Khrykin on 2019-07-05.
 //
 
+#include <chrono>
+#include <map>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <vector>
+
 #include <catch2/catch.hpp>
 
 #include "strategy.h"
 
+namespace {
+    // Previous implementation of session dragging on a plain list of slots' activities,
+    // kept as a reference. It tracks initial indices of the moved slots in a map,
+    // and rescans all of them after every restored session.
+    // Unlike the original, it rejects drags past the first slot, doesn't treat
+    // a session that starts at the first slot as starting at the second one,
+    // and doesn't stop restoring sessions when a restored one shrinks the map.
+    class reference_drag_operation {
+    public:
+        using index_t = int;
+        using slots_t = std::vector<stg::activity_id>;
+
+        explicit reference_drag_operation(slots_t slots) : slots(std::move(slots)) {}
+
+        auto data() const -> const slots_t & {
+            return slots;
+        }
+
+        // Returns the new first index of the dragged range, or nothing if it can't be dragged.
+        auto record_drag(index_t first_index, index_t last_index, int distance) -> std::optional<index_t> {
+            auto new_dragged_range = silently_drag({first_index, last_index}, distance);
+            if (!new_dragged_range)
+                return std::nullopt;
+
+            restore_displaced_sessions(*new_dragged_range);
+
+            return new_dragged_range->first;
+        }
+
+    private:
+        struct range {
+            index_t first = 0;
+            index_t last = 0;
+
+            auto size() const -> index_t {
+                return last - first + 1;
+            }
+
+            auto contains(index_t index) const -> bool {
+                return index >= first && index <= last;
+            }
+        };
+
+        slots_t slots;
+        std::map<index_t, index_t> initial_indices;
+
+        auto last_slot_index() const -> index_t {
+            return (index_t) slots.size() - 1;
+        }
+
+        auto silently_drag(const range &range_to_drag, int distance) -> std::optional<range> {
+            auto destination_index = distance < 0
+                                         ? range_to_drag.first + distance
+                                         : range_to_drag.last + distance;
+
+            if (destination_index < 0 || destination_index > last_slot_index())
+                return std::nullopt;
+
+            auto cache_range = distance < 0
+                                   ? range{destination_index, range_to_drag.first - 1}
+                                   : range{range_to_drag.last + 1, destination_index};
+
+            auto restore_cache_first_index = distance < 0
+                                                 ? destination_index + range_to_drag.size()
+                                                 : range_to_drag.first;
+
+            auto new_first_index = distance < 0
+                                       ? destination_index
+                                       : destination_index - range_to_drag.size() + 1;
+
+            auto cache = std::vector<std::pair<index_t, stg::activity_id>>();
+            for (auto i = cache_range.first; i <= cache_range.last; i++)
+                cache.emplace_back(i, slots[i]);
+
+            auto movements = std::map<index_t, index_t>();
+
+            for (auto i = 0; i < range_to_drag.size(); i++) {
+                movements[range_to_drag.first + i] = new_first_index + i;
+                slots[new_first_index + i] = slots[range_to_drag.first + i];
+            }
+
+            for (auto i = 0; i < (index_t) cache.size(); i++) {
+                auto [old_index, activity] = cache[i];
+                movements[old_index] = restore_cache_first_index + i;
+                slots[restore_cache_first_index + i] = activity;
+            }
+
+            apply_movements_to_history(movements);
+
+            return range{new_first_index, new_first_index + range_to_drag.size() - 1};
+        }
+
+        void apply_movements_to_history(const std::map<index_t, index_t> &movements) {
+            auto moved_initial_indices = std::map<index_t, index_t>();
+
+            for (auto const &[old_index, new_index] : movements)
+                moved_initial_indices[new_index] = initial_index(old_index);
+
+            for (auto const &[index, initial_index] : moved_initial_indices) {
+                if (index == initial_index) {
+                    initial_indices.erase(index);
+                } else {
+                    initial_indices[index] = initial_index;
+                }
+            }
+        }
+
+        void restore_displaced_sessions(const range &dragged_range) {
+            auto has_moved = true;
+
+            while (has_moved) {
+                has_moved = false;
+
+                for (auto const &[current_index, initial_index] : initial_indices) {
+                    if (dragged_range.contains(current_index) || !slots[current_index])
+                        continue;
+
+                    auto session_range = session_range_for(current_index);
+                    auto initial_session_begin_index = this->initial_index(session_range.first);
+
+                    if (initial_session_begin_index != session_range.first) {
+                        auto can_move_to = available_movement_index(session_range,
+                                                                    initial_session_begin_index);
+
+                        if (can_move_to != session_range.first) {
+                            silently_drag(session_range, can_move_to - session_range.first);
+                            has_moved = true;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+
+        auto initial_index(index_t index) const -> index_t {
+            auto it = initial_indices.find(index);
+            return it != initial_indices.end() ? it->second : index;
+        }
+
+        auto session_range_for(index_t index) const -> range {
+            auto result = range{index, index};
+
+            while (result.first > 0 && slots[result.first - 1] == slots[index])
+                result.first--;
+
+            while (result.last < last_slot_index() && slots[result.last + 1] == slots[index])
+                result.last++;
+
+            return result;
+        }
+
+        auto available_movement_index(const range &session_range, index_t target_index) const -> index_t {
+            auto result = session_range.first;
+
+            if (session_range.first > target_index) {
+                for (auto i = session_range.first - 1; i >= target_index; i--) {
+                    if (slots[i] && slots[i] != slots[session_range.first])
+                        break;
+
+                    result = i;
+                }
+            } else if (session_range.first < target_index) {
+                if (target_index + session_range.size() > last_slot_index())
+                    return result;
+
+                for (auto i = session_range.last + 1; i <= target_index + session_range.size() - 1; i++) {
+                    if (slots[i] && slots[i] != slots[session_range.last])
+                        break;
+
+                    result = i - session_range.size() + 1;
+                }
+            }
+
+            return result;
+        }
+    };
+
+    constexpr auto busy_day_long_session_length = 60;
+
+    // A busy day of one-minute slots: a long session at the beginning,
+    // then short sessions separated by single empty slots.
+    void place_busy_day(stg::strategy &strategy) {
+        auto number_of_time_slots = (int) strategy.number_of_time_slots();
+
+        strategy.add_activity(stg::activity("Long"));
+        strategy.add_activity(stg::activity("Short"));
+
+        auto long_session_indices = std::vector<stg::strategy::time_slot_index_t>(busy_day_long_session_length);
+        std::iota(long_session_indices.begin(), long_session_indices.end(), 0);
+
+        strategy.place_activity(0, long_session_indices);
+
+        for (auto index = busy_day_long_session_length + 1; index + 3 <= number_of_time_slots; index += 4) {
+            strategy.place_activity(1, {index, index + 1, index + 2});
+        }
+    }
+
+    // Drags the long session step by step to the end of the day and back,
+    // returns its final session index.
+    auto drag_through_busy_day(stg::strategy &strategy, int steps_count) -> int {
+        strategy.begin_dragging(0);
+
+        auto session_index = 0;
+
+        for (auto step = 0; step < steps_count; step++) {
+            session_index = strategy.drag_session(session_index, 1);
+        }
+
+        for (auto step = 0; step < steps_count; step++) {
+            session_index = strategy.drag_session(session_index, -1);
+        }
+
+        strategy.end_dragging();
+
+        return session_index;
+    }
+}
+
 TEST_CASE("Strategy activity sessions", "[strategy][sessions]") {
     auto strategy = stg::strategy();
 
@@ -20,26 +245,26 @@ TEST_CASE("Strategy activity sessions", "[strategy][sessions]") {
     SECTION("put activity in single slot") {
         strategy.place_activity(0, {0});
 
-        REQUIRE(strategy.sessions()[0].activity == strategy.activities().at(0));
+        REQUIRE(strategy.sessions()[0].activity == strategy.activities().id_at(0));
     }
 
     SECTION("put activity in adjacent slots") {
         strategy.place_activity(0, {0, 1});
 
-        REQUIRE(strategy.sessions()[0].activity == strategy.activities().at(0));
+        REQUIRE(strategy.sessions()[0].activity == strategy.activities().id_at(0));
         REQUIRE(strategy.sessions()[0].length() == 2);
     }
 
     SECTION("put activity in two groups of adjacent slots") {
         strategy.place_activity(0, {0, 1, 3, 4});
 
-        REQUIRE(strategy.sessions()[0].activity == strategy.activities().at(0));
+        REQUIRE(strategy.sessions()[0].activity == strategy.activities().id_at(0));
         REQUIRE(strategy.sessions()[0].length() == 2);
 
         REQUIRE(strategy.sessions()[1].activity == stg::strategy::no_activity);
         REQUIRE(strategy.sessions()[1].length() == 1);
 
-        REQUIRE(strategy.sessions()[2].activity == strategy.activities().at(0));
+        REQUIRE(strategy.sessions()[2].activity == strategy.activities().id_at(0));
         REQUIRE(strategy.sessions()[2].length() == 2);
     }
 
@@ -49,7 +274,7 @@ TEST_CASE("Strategy activity sessions", "[strategy][sessions]") {
 
         strategy.place_activity(0, {penultimate_index, last_index});
 
-        REQUIRE(strategy.sessions().last().activity == &strategy.activities()[0]);
+        REQUIRE(strategy.sessions().last().activity == strategy.activities().id_at(0));
         REQUIRE(strategy.sessions().last().length() == 2);
     }
 
@@ -57,10 +282,10 @@ TEST_CASE("Strategy activity sessions", "[strategy][sessions]") {
         strategy.place_activity(0, {0, 1});
         strategy.place_activity(1, {2, 3, 4});
 
-        REQUIRE(strategy.sessions()[0].activity == strategy.activities().at(0));
+        REQUIRE(strategy.sessions()[0].activity == strategy.activities().id_at(0));
         REQUIRE(strategy.sessions()[0].length() == 2);
 
-        REQUIRE(strategy.sessions()[1].activity == strategy.activities().at(1));
+        REQUIRE(strategy.sessions()[1].activity == strategy.activities().id_at(1));
         REQUIRE(strategy.sessions()[1].length() == 3);
     }
 
@@ -74,7 +299,7 @@ TEST_CASE("Strategy activity sessions", "[strategy][sessions]") {
             strategy.end_resizing();
 
             REQUIRE(strategy.sessions()[0].length() == 2);
-            REQUIRE(strategy.sessions()[0].activity == strategy.activities().at(1));
+            REQUIRE(strategy.sessions()[0].activity == strategy.activities().id_at(1));
 
             REQUIRE(strategy.sessions()[1].length() == strategy.number_of_time_slots() - 2);
             REQUIRE(strategy.sessions()[1].activity == stg::strategy::no_activity);
@@ -86,7 +311,7 @@ TEST_CASE("Strategy activity sessions", "[strategy][sessions]") {
             strategy.end_resizing();
 
             REQUIRE(strategy.sessions()[0].length() == 2);
-            REQUIRE(strategy.sessions()[0].activity == strategy.activities().at(0));
+            REQUIRE(strategy.sessions()[0].activity == strategy.activities().id_at(0));
 
             REQUIRE(strategy.sessions()[1].length() == strategy.number_of_time_slots() - 2);
             REQUIRE(strategy.sessions()[1].activity == stg::strategy::no_activity);
@@ -103,6 +328,56 @@ TEST_CASE("Strategy activity sessions", "[strategy][sessions]") {
         }
     }
 
+    SECTION("fill time slots shifting") {
+        strategy.place_activity(0, {0});
+        strategy.place_activity(1, {1});
+        strategy.place_activity(2, {3, 4});
+
+        SECTION("down") {
+            strategy.begin_resizing();
+            strategy.fill_time_slots_shifting(0, 1);
+            strategy.end_resizing();
+
+            REQUIRE(strategy.sessions()[0].activity == strategy.activities().id_at(0));
+            REQUIRE(strategy.sessions()[0].length() == 2);
+            REQUIRE(strategy.sessions()[1].activity == strategy.activities().id_at(1));
+            REQUIRE(strategy.sessions()[1].length() == 1);
+            REQUIRE(strategy.sessions()[2].activity == stg::strategy::no_activity);
+            REQUIRE(strategy.sessions()[2].length() == 1);
+            REQUIRE(strategy.sessions()[3].activity == strategy.activities().id_at(2));
+            REQUIRE(strategy.sessions()[3].length() == 2);
+        }
+
+        SECTION("up") {
+            strategy.begin_resizing();
+            strategy.fill_time_slots_shifting(4, 2);
+            strategy.end_resizing();
+
+            REQUIRE(strategy.sessions()[0].activity == strategy.activities().id_at(1));
+            REQUIRE(strategy.sessions()[0].length() == 1);
+            REQUIRE(strategy.sessions()[1].activity == stg::strategy::no_activity);
+            REQUIRE(strategy.sessions()[1].length() == 1);
+            REQUIRE(strategy.sessions()[2].activity == strategy.activities().id_at(2));
+            REQUIRE(strategy.sessions()[2].length() == 3);
+        }
+
+        SECTION("back and forth isn't a change") {
+            auto initial_time_slots = strategy.time_slots().data();
+
+            strategy.begin_resizing();
+            strategy.fill_time_slots(3, 5);
+            strategy.fill_time_slots(5, 5);
+            strategy.fill_time_slots(6, 5);
+            strategy.end_resizing();
+
+            REQUIRE(strategy.time_slots().data() == initial_time_slots);
+
+            // Undoes placing the last activity, since resizing wasn't recorded.
+            strategy.undo();
+            REQUIRE(strategy.time_slots()[3].activity == stg::strategy::no_activity);
+        }
+    }
+
     SECTION("drag activity session") {
         strategy.place_activity(1, {1, 2});
         strategy.place_activity(2, {3, 4, 5});
@@ -114,9 +389,9 @@ TEST_CASE("Strategy activity sessions", "[strategy][sessions]") {
 
             REQUIRE(strategy.sessions()[0].activity == stg::strategy::no_activity);
             REQUIRE(strategy.sessions()[0].length() == 1);
-            REQUIRE(strategy.sessions()[1].activity == strategy.activities().at(2));
+            REQUIRE(strategy.sessions()[1].activity == strategy.activities().id_at(2));
             REQUIRE(strategy.sessions()[1].length() == 3);
-            REQUIRE(strategy.sessions()[2].activity == strategy.activities().at(1));
+            REQUIRE(strategy.sessions()[2].activity == strategy.activities().id_at(1));
             REQUIRE(strategy.sessions()[2].length() == 2);
             REQUIRE(strategy.sessions()[3].activity == stg::strategy::no_activity);
             REQUIRE(strategy.sessions()[3].length() == strategy.number_of_time_slots() - 6);
@@ -129,15 +404,80 @@ TEST_CASE("Strategy activity sessions", "[strategy][sessions]") {
 
             REQUIRE(strategy.sessions()[0].activity == stg::strategy::no_activity);
             REQUIRE(strategy.sessions()[0].length() == 1);
-            REQUIRE(strategy.sessions()[1].activity == strategy.activities().at(2));
+            REQUIRE(strategy.sessions()[1].activity == strategy.activities().id_at(2));
             REQUIRE(strategy.sessions()[1].length() == 2);
-            REQUIRE(strategy.sessions()[2].activity == strategy.activities().at(1));
+            REQUIRE(strategy.sessions()[2].activity == strategy.activities().id_at(1));
             REQUIRE(strategy.sessions()[2].length() == 2);
-            REQUIRE(strategy.sessions()[3].activity == strategy.activities().at(2));
+            REQUIRE(strategy.sessions()[3].activity == strategy.activities().id_at(2));
             REQUIRE(strategy.sessions()[3].length() == 1);
             REQUIRE(strategy.sessions()[4].activity == stg::strategy::no_activity);
             REQUIRE(strategy.sessions()[4].length() == strategy.number_of_time_slots() - 6);
         }
+
+        SECTION("past the first slot is rejected") {
+            auto initial_sessions = strategy.sessions().data();
+
+            strategy.begin_dragging(1);
+            auto dragged_index = strategy.drag_session(1, -2);
+
+            REQUIRE(dragged_index == 1);
+            REQUIRE(strategy.drag_preview().data() == initial_sessions);
+
+            strategy.end_dragging();
+
+            REQUIRE(strategy.sessions().data() == initial_sessions);
+        }
+
+        SECTION("preview doesn't touch the model until the end") {
+            auto sessions_callbacks_count = 0;
+            strategy.sessions().add_on_change_callback([&] { sessions_callbacks_count++; });
+
+            auto initial_sessions = strategy.sessions().data();
+
+            strategy.begin_dragging(2);
+            auto dragged_index = strategy.drag_session(2, -1);
+            dragged_index = strategy.drag_session(dragged_index, -1);
+
+            REQUIRE(dragged_index == 1);
+            REQUIRE(strategy.drag_preview()[1].activity == strategy.activities().id_at(2));
+            REQUIRE(strategy.sessions().data() == initial_sessions);
+            REQUIRE(sessions_callbacks_count == 0);
+
+            SECTION("end") {
+                strategy.end_dragging();
+
+                REQUIRE(sessions_callbacks_count == 1);
+                REQUIRE(strategy.drag_preview().empty());
+                REQUIRE(strategy.sessions()[1].activity == strategy.activities().id_at(2));
+                REQUIRE(strategy.sessions()[1].length() == 3);
+            }
+
+            SECTION("cancel") {
+                strategy.cancel_dragging();
+
+                REQUIRE(sessions_callbacks_count == 0);
+                REQUIRE(strategy.drag_preview().empty());
+                REQUIRE(strategy.sessions().data() == initial_sessions);
+            }
+        }
+    }
+
+    SECTION("drag session next to a session at the first slot") {
+        strategy.place_activity(0, {0, 2});
+        strategy.place_activity(1, {1});
+
+        strategy.begin_dragging(1);
+        auto dragged_index = strategy.drag_session(1, 2);
+        strategy.end_dragging();
+
+        // The displaced session merges with the one at the first slot and stays there.
+        REQUIRE(dragged_index == 2);
+        REQUIRE(strategy.sessions()[0].activity == strategy.activities().id_at(0));
+        REQUIRE(strategy.sessions()[0].length() == 2);
+        REQUIRE(strategy.sessions()[1].activity == stg::strategy::no_activity);
+        REQUIRE(strategy.sessions()[1].length() == 1);
+        REQUIRE(strategy.sessions()[2].activity == strategy.activities().id_at(1));
+        REQUIRE(strategy.sessions()[2].length() == 1);
     }
 
     SECTION("activity session index for time slot index") {
@@ -170,4 +510,109 @@ TEST_CASE("Strategy sessions on change notifications", "[strategy][sessions]") {
 
         REQUIRE(!callbackWasCalled);
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Strategy session dragging matches reference implementation", "[strategy][sessions]") {
+    auto random = std::mt19937(42);
+
+    auto preview_activities = [](const stg::strategy &strategy) {
+        auto result = reference_drag_operation::slots_t();
+        for (const auto &session : strategy.drag_preview()) {
+            result.insert(result.end(), session.length(), session.activity);
+        }
+
+        return result;
+    };
+
+    for (auto scenario = 0; scenario < 300; scenario++) {
+        // One-minute slots starting at zero, so slot's begin time is its index.
+        auto strategy = stg::strategy(0, 1, 24);
+        auto number_of_time_slots = (int) strategy.number_of_time_slots();
+
+        auto activities_count = 1 + (int) (random() % 3);
+        for (auto i = 0; i < activities_count; i++) {
+            strategy.add_activity(stg::activity("Some " + std::to_string(i)));
+        }
+
+        for (auto i = 0; i < 8; i++) {
+            auto activity_index = (int) (random() % activities_count);
+            auto first_index = (int) (random() % number_of_time_slots);
+            auto length = 1 + (int) (random() % 4);
+
+            auto indices = std::vector<stg::strategy::time_slot_index_t>();
+            for (auto index = first_index; index < std::min(first_index + length, number_of_time_slots); index++) {
+                indices.push_back(index);
+            }
+
+            strategy.place_activity(activity_index, indices);
+        }
+
+        for (auto drag = 0; drag < 3; drag++) {
+            auto session_index = (int) (random() % strategy.sessions().size());
+
+            strategy.begin_dragging(session_index);
+            auto reference = reference_drag_operation(preview_activities(strategy));
+
+            for (auto step = 0; step < 8; step++) {
+                auto distance = (int) (random() % 9) - 4;
+
+                const auto &session = strategy.drag_preview()[session_index];
+                auto first_index = (int) session.time_slots.front().begin_time;
+                auto last_index = (int) session.time_slots.back().begin_time;
+                auto is_draggable = session.activity != stg::strategy::no_activity && distance != 0;
+
+                auto new_session_index = strategy.drag_session(session_index, distance);
+                auto new_first_index = is_draggable
+                                           ? reference.record_drag(first_index, last_index, distance)
+                                           : std::nullopt;
+
+                auto expected_session_index = new_first_index
+                                                  ? strategy.drag_preview().session_index_for_time_slot_index(*new_first_index)
+                                                  : session_index;
+
+                REQUIRE(new_session_index == expected_session_index);
+                REQUIRE(preview_activities(strategy) == reference.data());
+
+                session_index = new_session_index;
+            }
+
+            strategy.end_dragging();
+        }
+    }
+}
+
+TEST_CASE("Strategy session dragging through a busy day", "[strategy][sessions]") {
+    auto strategy = stg::strategy(0, 1, 24 * 60);
+    place_busy_day(strategy);
+
+    auto steps_count = (int) strategy.number_of_time_slots() - busy_day_long_session_length;
+
+    auto session_index = drag_through_busy_day(strategy, steps_count);
+
+    REQUIRE(session_index == 0);
+    REQUIRE(strategy.sessions()[0].activity == strategy.activities().id_at(0));
+    REQUIRE(strategy.sessions()[0].length() == busy_day_long_session_length);
+}
+
+// Excluded from default runs, since the bound holds for optimized builds only.
+TEST_CASE("Strategy session dragging benchmark", "[strategy][sessions][.benchmark]") {
+    using namespace std::chrono;
+
+    auto strategy = stg::strategy(0, 1, 24 * 60);
+    place_busy_day(strategy);
+
+    auto number_of_time_slots = (int) strategy.number_of_time_slots();
+    auto steps_count = number_of_time_slots - busy_day_long_session_length;
+
+    auto start_time = steady_clock::now();
+    drag_through_busy_day(strategy, steps_count);
+
+    auto elapsed_microseconds = duration_cast<microseconds>(steady_clock::now() - start_time).count();
+    auto mean_step_microseconds = (double) elapsed_microseconds / (2 * steps_count);
+
+    WARN("dragged through " << number_of_time_slots << " slots, "
+                            << "mean drag step time " << mean_step_microseconds << " us");
+
+    // The previous implementation took about 4 ms per step in unoptimized builds.
+    REQUIRE(mean_step_microseconds < 1000);
+}
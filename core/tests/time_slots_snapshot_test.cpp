@@ -0,0 +1,207 @@
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+#include "strategy.h"
+#include "timeslotssnapshot.h"
+
+TEST_CASE("Time slots snapshot", "[time_slots][snapshot]") {
+    auto activity = stg::activity_id(0, 1);
+
+    auto time_slots = std::vector<stg::time_slot>();
+    for (auto i = 0u; i < 150; i++) {
+        time_slots.emplace_back(i * 15, 15);
+    }
+
+    auto snapshot = stg::time_slots_snapshot(time_slots);
+
+    SECTION("keeps the slots") {
+        REQUIRE(snapshot.size() == 150);
+        REQUIRE(snapshot[149] == time_slots[149]);
+
+        auto copied_time_slots = std::vector<stg::time_slot>();
+        snapshot.copy_to(copied_time_slots);
+
+        REQUIRE(copied_time_slots == time_slots);
+    }
+
+    SECTION("isn't affected by changes of the slots") {
+        time_slots[70].activity = activity;
+
+        REQUIRE(snapshot[70].activity == stg::time_slot::no_activity);
+    }
+
+    SECTION("updating with the same slots gives an equal snapshot") {
+        REQUIRE(snapshot.updated(time_slots) == snapshot);
+    }
+
+    SECTION("updating reflects changed and resized slots") {
+        time_slots[70].activity = activity;
+        auto updated_snapshot = snapshot.updated(time_slots);
+
+        REQUIRE(updated_snapshot != snapshot);
+        REQUIRE(updated_snapshot[70].activity == activity);
+        REQUIRE(updated_snapshot[69] == snapshot[69]);
+
+        time_slots.pop_back();
+        auto shrunk_snapshot = updated_snapshot.updated(time_slots);
+
+        REQUIRE(shrunk_snapshot.size() == 149);
+        REQUIRE(shrunk_snapshot[70].activity == activity);
+    }
+
+    SECTION("updating with changed bounds only looks at their pages") {
+        time_slots[10].activity = activity;
+        time_slots[70].activity = activity;
+
+        auto hash = stg::time_slots_snapshot::content_hash_of(time_slots);
+        auto updated_snapshot = snapshot.updated(time_slots, 70, 70, 0, hash, nullptr);
+
+        REQUIRE(updated_snapshot[70].activity == activity);
+        REQUIRE(updated_snapshot[10].activity == stg::time_slot::no_activity);
+
+        auto unchanged_snapshot = snapshot.updated(time_slots, 0, -1, 0, hash, nullptr);
+
+        REQUIRE(unchanged_snapshot[10].activity == stg::time_slot::no_activity);
+        REQUIRE(unchanged_snapshot[70].activity == stg::time_slot::no_activity);
+    }
+
+    SECTION("snapshots with different runs aren't equal") {
+        auto hidden_slots = time_slots;
+        hidden_slots.emplace_back(150 * 15, 15, activity);
+
+        auto runs = std::make_shared<const stg::activity_runs>(time_slots);
+        auto hidden_runs = std::make_shared<const stg::activity_runs>(hidden_slots);
+
+        auto hash = stg::time_slots_snapshot::content_hash_of(time_slots);
+
+        REQUIRE(snapshot.updated(time_slots, 0, hash, runs) != snapshot.updated(time_slots, 0, hash, hidden_runs));
+        REQUIRE(snapshot.updated(time_slots, 0, hash, runs) == snapshot.updated(time_slots, 0, hash, runs));
+    }
+
+    SECTION("projected snapshot keeps the grid and runs only") {
+        time_slots[70].activity = activity;
+
+        auto runs = std::make_shared<const stg::activity_runs>(time_slots);
+        auto hash = stg::time_slots_snapshot::content_hash_of(time_slots);
+        auto projected_snapshot = stg::time_slots_snapshot::projected(0, 15, 150, 0, hash, runs);
+
+        auto copied_time_slots = std::vector<stg::time_slot>();
+        projected_snapshot.copy_to(copied_time_slots);
+
+        REQUIRE(copied_time_slots == time_slots);
+        REQUIRE(projected_snapshot == snapshot.updated(time_slots));
+        REQUIRE(projected_snapshot != snapshot);
+        REQUIRE(projected_snapshot.paged()[70].activity == activity);
+    }
+}
+
+TEST_CASE("Strategy time slots snapshots", "[strategy][snapshot]") {
+    auto strategy = stg::strategy();
+    strategy.add_activity(stg::activity("Some"));
+
+    strategy.place_activity(0, {0, 1});
+    strategy.place_activity(0, {5});
+
+    SECTION("undo restores slots from history") {
+        strategy.undo();
+
+        REQUIRE(strategy.time_slots()[0].activity == strategy.activities().id_at(0));
+        REQUIRE(strategy.time_slots()[5].activity == stg::strategy::no_activity);
+
+        strategy.redo();
+
+        REQUIRE(strategy.time_slots()[5].activity == strategy.activities().id_at(0));
+    }
+
+    SECTION("dragging twice reuses the shadow slots") {
+        strategy.begin_dragging(0);
+        strategy.drag_session(0, 1);
+        strategy.cancel_dragging();
+
+        strategy.begin_dragging(0);
+        strategy.drag_session(0, 2);
+        strategy.end_dragging();
+
+        REQUIRE(strategy.time_slots()[0].activity == stg::strategy::no_activity);
+        REQUIRE(strategy.time_slots()[2].activity == strategy.activities().id_at(0));
+        REQUIRE(strategy.time_slots()[3].activity == strategy.activities().id_at(0));
+
+        strategy.undo();
+
+        REQUIRE(strategy.time_slots()[0].activity == strategy.activities().id_at(0));
+        REQUIRE(strategy.time_slots()[1].activity == strategy.activities().id_at(0));
+    }
+}
+
+TEST_CASE("Time slots change detection", "[strategy][snapshot][versioning]") {
+    auto strategy = stg::strategy();
+    strategy.add_activity(stg::activity("Some"));
+
+    const auto &time_slots = strategy.time_slots();
+
+    auto initial_version = time_slots.version();
+    auto initial_hash = time_slots.content_hash();
+    auto initial_snapshot = time_slots.snapshot();
+
+    SECTION("version and hash change on modification") {
+        strategy.place_activity(0, {3});
+
+        REQUIRE(time_slots.version() != initial_version);
+        REQUIRE(time_slots.content_hash() != initial_hash);
+        REQUIRE(time_slots.differs_from(initial_snapshot));
+    }
+
+    SECTION("no-op modification keeps the version") {
+        strategy.make_empty_at({3});
+
+        REQUIRE(time_slots.version() == initial_version);
+        REQUIRE_FALSE(time_slots.differs_from(initial_snapshot));
+    }
+
+    SECTION("hash is restored when changes are reverted") {
+        strategy.place_activity(0, {3});
+        strategy.make_empty_at({3});
+
+        REQUIRE(time_slots.version() != initial_version);
+        REQUIRE(time_slots.content_hash() == initial_hash);
+        REQUIRE_FALSE(time_slots.differs_from(initial_snapshot));
+    }
+
+    SECTION("hash depends on the order of slots") {
+        strategy.add_activity(stg::activity("Other"));
+
+        strategy.place_activity(0, {0});
+        strategy.place_activity(1, {1});
+        auto hash = time_slots.content_hash();
+
+        strategy.place_activity(1, {0});
+        strategy.place_activity(0, {1});
+
+        REQUIRE(time_slots.content_hash() != hash);
+    }
+
+    SECTION("activities hash is restored when changes are reverted") {
+        auto activities_hash = strategy.activities().content_hash();
+
+        strategy.edit_activity(0, stg::activity("Edited"));
+        REQUIRE(strategy.activities().content_hash() != activities_hash);
+
+        strategy.edit_activity(0, stg::activity("Some"));
+        REQUIRE(strategy.activities().content_hash() == activities_hash);
+    }
+
+    SECTION("dragging back and forth isn't recorded") {
+        strategy.place_activity(0, {3});
+
+        strategy.begin_dragging(1);
+        auto session_index = strategy.drag_session(1, 2);
+        strategy.drag_session(session_index, -2);
+        strategy.end_dragging();
+
+        strategy.undo();
+
+        REQUIRE(time_slots[3].activity == stg::strategy::no_activity);
+        REQUIRE(strategy.activities().size() == 1);
+    }
+}
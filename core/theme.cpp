@@ -14,11 +14,8 @@ namespace stg {
         return get_base_color();
     }
 
-    auto theme::session_background_color(const session &session, bool is_selected) const -> color {
-        if (!session.activity)
-            return color::clear_color;
-
-        auto activity_color = session.activity->color();
+    auto theme::session_background_color(const activity &activity, bool is_selected) const -> color {
+        auto activity_color = activity.color();
 
         if (activity_color.lightness() < 0.5 &&
             is_dark_mode()) {
@@ -30,17 +27,14 @@ namespace stg {
                    : activity_color.with_alpha_component(0.15);
     }
 
-    auto theme::session_ruler_color(const session &session, bool is_selected) const -> color {
+    auto theme::session_ruler_color(const activity &activity, bool is_selected) const -> color {
         return is_selected
-                   ? session.activity->desaturated_dark_color()
-                   : session.activity->desaturated_light_color();
+                   ? activity.desaturated_dark_color()
+                   : activity.desaturated_light_color();
     }
 
-    auto theme::session_duration_color(const session &session, bool is_selected) const -> color {
-        if (!session.activity)
-            return color::clear_color;
-
-        const auto activity_color = session.activity->color();
+    auto theme::session_duration_color(const activity &activity, bool is_selected) const -> color {
+        const auto activity_color = activity.color();
         auto default_duration_color = text_color()
                                           .blended_with(activity_color
                                                             .with_hsl(activity_color.hue(), 0.2, 0.7)
@@ -56,16 +50,16 @@ namespace stg {
                                   : default_duration_color;
 
 
-        if (session.activity->color().lightness() < 0.2 && is_selected) {
+        if (activity.color().lightness() < 0.2 && is_selected) {
             duration_color = color::white_color
-                                 .blended_with(session.activity->color().with_alpha_component(0.5));
+                                 .blended_with(activity.color().with_alpha_component(0.5));
         }
 
         return duration_color;
     }
 
-    auto theme::session_title_color(const session &session, bool is_selected) const -> color {
-        auto activity_color = session.activity->color();
+    auto theme::session_title_color(const activity &activity, bool is_selected) const -> color {
+        auto activity_color = activity.color();
         auto lightened_activity_color = activity_color.with_hsl(activity_color.hue(),
                                                                 activity_color.saturation(),
                                                                 1 - activity_color.lightness());
@@ -76,7 +70,7 @@ namespace stg {
             if (activity_color.lightness() < 0.5 && is_dark_mode())
                 return lightened_activity_color;
 
-            return session.activity->color();
+            return activity.color();
         }
     }
 
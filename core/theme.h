@@ -10,7 +10,6 @@
 
 #include "activity.h"
 #include "color.h"
-#include "session.h"
 
 namespace stg {
     struct theme {
@@ -21,10 +20,11 @@ namespace stg {
         auto base_color() const -> color;
         auto is_dark_mode() const -> bool;
 
-        auto session_background_color(const session &session, bool is_selected) const -> color;
-        auto session_ruler_color(const session &session, bool is_selected) const -> color;
-        auto session_duration_color(const session &session, bool is_selected) const -> color;
-        auto session_title_color(const session &session, bool is_selected) const -> color;
+        // Colors of a session of the given activity.
+        auto session_background_color(const activity &activity, bool is_selected) const -> color;
+        auto session_ruler_color(const activity &activity, bool is_selected) const -> color;
+        auto session_duration_color(const activity &activity, bool is_selected) const -> color;
+        auto session_title_color(const activity &activity, bool is_selected) const -> color;
     };
 }
 
@@ -31,6 +31,7 @@ namespace stg::time_utils {
 
 #pragma mark - Getting Calendar Time from Relative Time
 
+    auto today_timestamp() -> time_t;
     auto calendar_time_from_seconds(seconds seconds_in_today) -> time_t;
     auto calendar_time_from_minutes(minutes minutes_in_today) -> time_t;
 
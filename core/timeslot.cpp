@@ -3,13 +3,12 @@
 //
 
 #include "timeslot.h"
-#include "activity.h"
 #include "time_utils.h"
 
 namespace stg {
-    time_slot::time_slot(minutes begin_time, minutes duration, stg::activity *activity) : begin_time(begin_time),
-                                                                                          duration(duration),
-                                                                                          activity(activity) {}
+    time_slot::time_slot(minutes begin_time, minutes duration, activity_id activity) : begin_time(begin_time),
+                                                                                       duration(duration),
+                                                                                       activity(activity) {}
 
     auto time_slot::end_time() const -> time_slot::minutes {
         return begin_time + duration;
@@ -19,6 +18,14 @@ namespace stg {
         return activity == no_activity;
     }
 
+    auto time_slot::content_hash() const -> content_hash_t {
+        auto result = mix_hash(begin_time);
+        result = combine_hash(result, duration);
+        result = combine_hash(result, activity.content_hash());
+
+        return result;
+    }
+
     auto time_slot::calendar_begin_time() const -> std::time_t {
         return time_utils::calendar_time_from_minutes(begin_time);
     }
@@ -37,11 +44,7 @@ namespace stg {
 
     auto operator<<(std::ostream &os, const time_slot &slot) -> std::ostream & {
         os << "time_slot(";
-        if (slot.activity) {
-            os << *slot.activity;
-        } else {
-            os << "none";
-        }
+        os << slot.activity;
         os << ", begin_time: " << slot.begin_time;
         os << ", duration: " << slot.duration;
 
@@ -8,9 +8,10 @@
 #include <ctime>
 #include <iostream>
 
-namespace stg {
-    struct activity;
+#include "activityid.h"
+#include "stghash.h"
 
+namespace stg {
     struct time_slot {
         using minutes = unsigned;
 
@@ -19,9 +20,9 @@ namespace stg {
         minutes begin_time = 0;
         minutes duration = 0;
 
-        stg::activity *activity = no_activity;
+        activity_id activity = no_activity;
 
-        time_slot(minutes begin_time, minutes duration, stg::activity *activity = no_activity);
+        time_slot(minutes begin_time, minutes duration, activity_id activity = no_activity);
 
         auto end_time() const -> minutes;
 
@@ -30,6 +31,8 @@ namespace stg {
 
         auto empty() const -> bool;
 
+        auto content_hash() const -> content_hash_t;
+
         friend auto operator==(const time_slot &lhs, const time_slot &rhs) -> bool;
         friend auto operator!=(const time_slot &lhs, const time_slot &rhs) -> bool;
         friend auto operator<<(std::ostream &os, const time_slot &slot) -> std::ostream &;
@@ -0,0 +1,255 @@
+#include <algorithm>
+#include <cassert>
+
+#include "timeslotssnapshot.h"
+
+namespace stg {
+    time_slots_snapshot::time_slots_snapshot(const data_t &time_slots)
+        : _size(static_cast<index_t>(time_slots.size())),
+          _content_hash(content_hash_of(time_slots)) {
+        auto new_pages = pages_table();
+        new_pages.reserve((_size + page_size - 1) / page_size);
+
+        for (auto page_index = 0; page_index * page_size < _size; page_index++) {
+            new_pages.push_back(make_page(time_slots, page_index));
+        }
+
+        pages = std::make_shared<const pages_table>(std::move(new_pages));
+    }
+
+    auto time_slots_snapshot::projected(minutes begin_time,
+                                        minutes slot_duration,
+                                        index_t size,
+                                        version_t version,
+                                        content_hash_t content_hash,
+                                        runs_ptr runs) -> time_slots_snapshot {
+        assert(runs && "Projected snapshot must have runs");
+
+        auto result = time_slots_snapshot();
+        result._size = size;
+        result._version = version;
+        result._content_hash = content_hash;
+        result._runs = std::move(runs);
+
+        result._is_projected = true;
+        result.begin_time = begin_time;
+        result.slot_duration = slot_duration;
+
+        return result;
+    }
+
+    auto time_slots_snapshot::updated(const data_t &time_slots) const -> time_slots_snapshot {
+        return updated(time_slots, 0, content_hash_of(time_slots), nullptr);
+    }
+
+    auto time_slots_snapshot::updated(const data_t &time_slots,
+                                      version_t version,
+                                      content_hash_t content_hash,
+                                      runs_ptr runs) const -> time_slots_snapshot {
+        return updated(time_slots,
+                       0,
+                       static_cast<index_t>(time_slots.size()) - 1,
+                       version,
+                       content_hash,
+                       std::move(runs));
+    }
+
+    auto time_slots_snapshot::updated(const data_t &time_slots,
+                                      index_t first_changed_index,
+                                      index_t last_changed_index,
+                                      version_t version,
+                                      content_hash_t content_hash,
+                                      runs_ptr runs) const -> time_slots_snapshot {
+        auto new_size = static_cast<index_t>(time_slots.size());
+        auto pages_count = (new_size + page_size - 1) / page_size;
+
+        // Any page might have changed if there are no pages to reuse yet,
+        // or if the number of slots has changed.
+        auto first_changed_page_index = 0;
+        auto last_changed_page_index = pages_count - 1;
+
+        auto has_changes = !pages || new_size != _size;
+        if (!has_changes) {
+            first_changed_page_index = std::max(first_changed_index, 0) / page_size;
+            last_changed_page_index = last_changed_index >= first_changed_index
+                                          ? std::min(last_changed_index / page_size, pages_count - 1)
+                                          : -1;
+        }
+
+        // The pages table is only copied after the first change.
+        auto new_pages = pages_table();
+        if (has_changes) {
+            new_pages = pages ? *pages : pages_table();
+            new_pages.resize(pages_count);
+        }
+
+        for (auto page_index = first_changed_page_index; page_index <= last_changed_page_index; page_index++) {
+            auto reusable = pages &&
+                            page_index < static_cast<index_t>(pages->size()) &&
+                            page_is_equal(*(*pages)[page_index], time_slots, page_index);
+
+            if (reusable)
+                continue;
+
+            if (!has_changes) {
+                new_pages = *pages;
+                has_changes = true;
+            }
+
+            new_pages[page_index] = make_page(time_slots, page_index);
+        }
+
+        auto result = *this;
+        if (has_changes) {
+            result.pages = std::make_shared<const pages_table>(std::move(new_pages));
+            result._size = new_size;
+        }
+
+        result._version = version;
+        result._content_hash = content_hash;
+        result._runs = std::move(runs);
+        result._is_projected = false;
+
+        return result;
+    }
+
+    auto time_slots_snapshot::size() const -> index_t {
+        return _size;
+    }
+
+    auto time_slots_snapshot::empty() const -> bool {
+        return _size == 0;
+    }
+
+    auto time_slots_snapshot::is_projected() const -> bool {
+        return _is_projected;
+    }
+
+    auto time_slots_snapshot::paged() const -> time_slots_snapshot {
+        if (!_is_projected)
+            return *this;
+
+        auto time_slots = data_t();
+        copy_to(time_slots);
+
+        return time_slots_snapshot().updated(time_slots, _version, _content_hash, _runs);
+    }
+
+    auto time_slots_snapshot::version() const -> version_t {
+        return _version;
+    }
+
+    auto time_slots_snapshot::content_hash() const -> content_hash_t {
+        return _content_hash;
+    }
+
+    auto time_slots_snapshot::runs() const -> const runs_ptr & {
+        return _runs;
+    }
+
+    auto time_slots_snapshot::content_hash_of(const data_t &time_slots) -> content_hash_t {
+        content_hash_t result = 0;
+        for (size_t index = 0; index < time_slots.size(); index++) {
+            result += list_item_hash(index, time_slots[index].content_hash());
+        }
+
+        return result;
+    }
+
+    auto time_slots_snapshot::operator[](index_t index) const -> const time_slot & {
+        assert(pages && "Projected snapshot has no pages");
+        return (*(*pages)[index / page_size])[index % page_size];
+    }
+
+    void time_slots_snapshot::copy_to(data_t &time_slots) const {
+        time_slots.clear();
+        time_slots.reserve(_size);
+
+        if (_is_projected) {
+            for (auto slot_index = 0; slot_index < _size; slot_index++) {
+                time_slots.emplace_back(begin_time + slot_index * slot_duration, slot_duration);
+            }
+
+            _runs->project(time_slots);
+            return;
+        }
+
+        if (!pages)
+            return;
+
+        for (const auto &page : *pages) {
+            time_slots.insert(time_slots.end(), page->begin(), page->end());
+        }
+    }
+
+    auto time_slots_snapshot::make_page(const data_t &time_slots, index_t page_index) -> page_ptr {
+        auto begin_index = page_index * page_size;
+        auto end_index = std::min(begin_index + page_size, static_cast<index_t>(time_slots.size()));
+
+        return std::make_shared<const page>(time_slots.begin() + begin_index,
+                                            time_slots.begin() + end_index);
+    }
+
+    auto time_slots_snapshot::page_is_equal(const page &page,
+                                            const data_t &time_slots,
+                                            index_t page_index) -> bool {
+        auto begin_index = page_index * page_size;
+        auto end_index = std::min(begin_index + page_size, static_cast<index_t>(time_slots.size()));
+
+        return std::equal(page.begin(), page.end(),
+                          time_slots.begin() + begin_index,
+                          time_slots.begin() + end_index);
+    }
+
+    // Equal versions also mean equal runs,
+    // since runs can only change along with the version.
+    auto operator==(const time_slots_snapshot &lhs,
+                    const time_slots_snapshot &rhs) -> bool {
+        if (lhs._version != 0 && lhs._version == rhs._version)
+            return true;
+
+        if (lhs._size != rhs._size || lhs._content_hash != rhs._content_hash)
+            return false;
+
+        if (lhs._runs && rhs._runs &&
+            lhs._runs != rhs._runs &&
+            lhs._runs->data() != rhs._runs->data())
+            return false;
+
+        if (lhs._is_projected || rhs._is_projected) {
+            // Runs are the same, so are slots projected on the same grid.
+            if (lhs._is_projected && rhs._is_projected &&
+                lhs.begin_time == rhs.begin_time &&
+                lhs.slot_duration == rhs.slot_duration)
+                return true;
+
+            auto lhs_time_slots = time_slots_snapshot::data_t();
+            auto rhs_time_slots = time_slots_snapshot::data_t();
+            lhs.copy_to(lhs_time_slots);
+            rhs.copy_to(rhs_time_slots);
+
+            return lhs_time_slots == rhs_time_slots;
+        }
+
+        if (lhs.pages == rhs.pages)
+            return true;
+
+        if (!lhs.pages || !rhs.pages)
+            return lhs._size == 0;
+
+        for (size_t page_index = 0; page_index < lhs.pages->size(); page_index++) {
+            const auto &lhs_page = (*lhs.pages)[page_index];
+            const auto &rhs_page = (*rhs.pages)[page_index];
+
+            if (lhs_page != rhs_page && *lhs_page != *rhs_page)
+                return false;
+        }
+
+        return true;
+    }
+
+    auto operator!=(const time_slots_snapshot &lhs,
+                    const time_slots_snapshot &rhs) -> bool {
+        return !(lhs == rhs);
+    }
+}
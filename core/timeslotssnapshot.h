@@ -0,0 +1,118 @@
+#ifndef STRATEGR_TIMESLOTSSNAPSHOT_H
+#define STRATEGR_TIMESLOTSSNAPSHOT_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "activityruns.h"
+#include "stghash.h"
+#include "timeslot.h"
+
+namespace stg {
+    // Immutable copy of time slots, split into reference-counted pages.
+    // Copying a snapshot is O(1), and snapshots made one after another
+    // share the pages that haven't changed in between.
+    //
+    // Slots that are projected from runs on a time grid can be kept
+    // as the grid and the runs only, without pages.
+    class time_slots_snapshot {
+    public:
+        using index_t = int;
+        using minutes = time_slot::minutes;
+        using data_t = std::vector<time_slot>;
+
+        // Zero means that the version is unknown.
+        using version_t = uint64_t;
+        using runs_ptr = std::shared_ptr<const activity_runs>;
+
+        static constexpr index_t page_size = 64;
+
+        time_slots_snapshot() = default;
+        explicit time_slots_snapshot(const data_t &time_slots);
+
+        // Snapshot of the slots the runs project to on the given grid.
+        // Slots are only projected again when the snapshot is copied to a vector.
+        static auto projected(minutes begin_time,
+                              minutes slot_duration,
+                              index_t size,
+                              version_t version,
+                              content_hash_t content_hash,
+                              runs_ptr runs) -> time_slots_snapshot;
+
+        // Returns a snapshot of the given slots that reuses this snapshot's pages
+        // where they're still equal, or this snapshot itself if nothing has changed.
+        // Version, content hash and runs must describe the given slots.
+        auto updated(const data_t &time_slots,
+                     version_t version,
+                     content_hash_t content_hash,
+                     runs_ptr runs) const -> time_slots_snapshot;
+
+        // Only compares pages of the slots between the given indices, both inclusive,
+        // other pages are reused as they are, unless the number of slots has changed.
+        auto updated(const data_t &time_slots,
+                     index_t first_changed_index,
+                     index_t last_changed_index,
+                     version_t version,
+                     content_hash_t content_hash,
+                     runs_ptr runs) const -> time_slots_snapshot;
+
+        // Calculates content hash of the given slots, version is unknown.
+        auto updated(const data_t &time_slots) const -> time_slots_snapshot;
+
+        auto size() const -> index_t;
+        auto empty() const -> bool;
+
+        auto is_projected() const -> bool;
+
+        // Returns this snapshot if it has pages,
+        // otherwise makes them from the projected slots.
+        auto paged() const -> time_slots_snapshot;
+
+        auto version() const -> version_t;
+        auto content_hash() const -> content_hash_t;
+
+        // Activity runs the slots are projected from, if they're known.
+        auto runs() const -> const runs_ptr &;
+
+        static auto content_hash_of(const data_t &time_slots) -> content_hash_t;
+
+        // Projected snapshots have no pages to index, see paged().
+        auto operator[](index_t index) const -> const time_slot &;
+
+        // Reuses the capacity of the given vector.
+        void copy_to(data_t &time_slots) const;
+
+        // Snapshots of the same version are equal,
+        // and snapshots with different hashes aren't.
+        // Otherwise runs are compared if both snapshots have them,
+        // since activities outside of the slots' time window come back
+        // when the grid changes, and then slots that aren't shared are compared.
+        friend auto operator==(const time_slots_snapshot &lhs,
+                               const time_slots_snapshot &rhs) -> bool;
+        friend auto operator!=(const time_slots_snapshot &lhs,
+                               const time_slots_snapshot &rhs) -> bool;
+
+    private:
+        using page = std::vector<time_slot>;
+        using page_ptr = std::shared_ptr<const page>;
+        using pages_table = std::vector<page_ptr>;
+
+        std::shared_ptr<const pages_table> pages = nullptr;
+        index_t _size = 0;
+
+        version_t _version = 0;
+        content_hash_t _content_hash = 0;
+        runs_ptr _runs = nullptr;
+
+        // Grid of a projected snapshot.
+        bool _is_projected = false;
+        minutes begin_time = 0;
+        minutes slot_duration = 0;
+
+        static auto make_page(const data_t &time_slots, index_t page_index) -> page_ptr;
+        static auto page_is_equal(const page &page, const data_t &time_slots, index_t page_index) -> bool;
+    };
+}
+
+#endif//STRATEGR_TIMESLOTSSNAPSHOT_H
@@ -17,36 +17,14 @@ namespace stg {
         if (begin_time == _begin_time)
             return;
 
-        auto old_begin_time = _begin_time;
-        auto old_data = _data;
-
-        _begin_time = begin_time;
-
         auto new_end_time = end_time();
         if (begin_time >= end_time()) {
             new_end_time += 24 * 60;
         }
 
-        auto new_number_of_slots = (new_end_time - begin_time) / slot_duration();
-
-        _data.resize(new_number_of_slots, time_slot(0, slot_duration()));
-
-        update_begin_times();
-
-        int slot_difference = ((int) begin_time - (int) old_begin_time) / (int) slot_duration();
-
-        for (const auto &slot : _data) {
-            auto slot_index = &slot - &_data[0];
-            auto old_index = slot_index + slot_difference;
+        _begin_time = begin_time;
 
-            stg::activity *activity = time_slot::no_activity;
-            if (old_index >= 0 && old_index < old_data.size()) {
-                const auto &old_slot = old_data[old_index];
-                activity = old_slot.activity;
-            }
-
-            _data[slot_index].activity = activity;
-        }
+        project_runs((new_end_time - begin_time) / slot_duration());
 
         on_change_event();
     }
@@ -65,21 +43,11 @@ namespace stg {
         if (slot_duration == _slot_duration)
             return;
 
-        auto old_state = time_slots_state(_data);
-
-        _slot_duration = slot_duration;
-
         auto new_number_of_slots = (end_time() - begin_time()) / slot_duration;
 
-        _data.resize(new_number_of_slots, time_slot(0, slot_duration));
-
-        for (auto &slot : _data) {
-            auto slot_index = &slot - &_data[0];
-            slot.duration = slot_duration;
-            slot.begin_time = make_slot_begin_time(begin_time(), (index_t) slot_index);
+        _slot_duration = slot_duration;
 
-            slot.activity = old_state.first_activity_in_time_window(slot.begin_time, slot.end_time());
-        }
+        project_runs(new_number_of_slots);
 
         on_change_event();
     }
@@ -93,11 +61,8 @@ namespace stg {
             return;
         }
 
-        if (new_number_of_slots < number_of_slots()) {
-            _data.erase(_data.begin() + new_number_of_slots, _data.end());
-        } else {
-            populate(last().end_time(), new_number_of_slots - number_of_slots());
-        }
+        // Slots that are added back get activities they had before removal.
+        project_runs(new_number_of_slots);
 
         on_change_event();
     }
@@ -108,6 +73,9 @@ namespace stg {
         : _begin_time(start_time),
           _slot_duration(slot_duration) {
         populate(start_time, number_of_slots);
+
+        reset_runs();
+        update_content_hash();
     }
 
     time_slots_state::time_slots_state(std::vector<time_slot> from_vector) {
@@ -115,6 +83,9 @@ namespace stg {
 
         _data = std::move(from_vector);
         reset_times();
+
+        reset_runs();
+        update_content_hash();
     }
 
     void time_slots_state::set_end_time(minutes end_time) {
@@ -142,7 +113,7 @@ namespace stg {
         _slot_duration = first_slot.duration;
     }
 
-    void time_slots_state::silently_fill_slots(index_t from_index, index_t till_index) {
+    auto time_slots_state::silently_fill_slots(index_t from_index, index_t till_index) -> bounds {
         auto source_index = from_index;
 
         if (till_index < from_index) {
@@ -152,73 +123,82 @@ namespace stg {
         make_safe_index(till_index);
         make_safe_index(from_index);
 
-        auto *source_activity = has_index(source_index)
+        auto source_activity = has_index(source_index)
                                     ? _data[source_index].activity
                                     : time_slot::no_activity;
 
         for (auto i = from_index; i <= till_index; i++) {
-            _data[i].activity = source_activity;
+            set_slot_activity(i, source_activity);
         }
+
+        return bounds{from_index, till_index};
     }
 
-    void time_slots_state::fill_slots(index_t from_index, index_t till_index) {
-        silently_fill_slots(from_index, till_index);
+    auto time_slots_state::fill_slots(index_t from_index, index_t till_index) -> bounds {
+        auto changed_bounds = silently_fill_slots(from_index, till_index);
 
         on_change_event();
-    }
 
-    void time_slots_state::fill_slots_shifting(index_t from_index, index_t till_index) {
-        auto result = _data;
+        return changed_bounds;
+    }
 
+    // Slots are shifted in place, only the part of the list
+    // that is pushed away by the filled range is touched.
+    auto time_slots_state::fill_slots_shifting(index_t from_index, index_t till_index) -> bounds {
         if (from_index == till_index)
-            return;
+            return bounds();
 
-        auto *source_activity = has_index(from_index)
+        auto source_activity = has_index(from_index)
                                     ? _data[from_index].activity
                                     : time_slot::no_activity;
 
-        auto activities_not_equal = [&](const auto &v) {
-            return v.activity != source_activity;
-        };
+        auto changed_bounds = bounds();
 
         if (till_index > from_index) {
-            auto movable_begin = from_index < 0
-                                     ? _data.begin()
-                                     : std::find_if(_data.begin() + from_index,
-                                                    std::next(_data.begin() + till_index),
-                                                    activities_not_equal);
-            if (movable_begin != _data.end()) {
-                auto movable_begin_index = std::distance(_data.begin(), movable_begin);
-                auto move_to_index = till_index + 1;
-
-                if (move_to_index < _data.size()) {
-                    auto move_distance = move_to_index - movable_begin_index;
-                    auto movable_last_index = _data.size() - 1 - move_distance;
-
-                    for (auto i = movable_begin_index; i <= movable_last_index; i++) {
-                        result[i + move_distance].activity = _data[i].activity;
-                    }
+            // The first slot in the range with a different activity,
+            // and everything below it is pushed down.
+            auto movable_begin_index = std::max(from_index, 0);
+            auto movable_end_index = std::min(till_index, size() - 1);
+
+            if (from_index >= 0) {
+                while (movable_begin_index <= movable_end_index &&
+                       _data[movable_begin_index].activity == source_activity) {
+                    movable_begin_index++;
                 }
             }
+
+            auto move_to_index = till_index + 1;
+            if (move_to_index < size() && move_to_index > movable_begin_index) {
+                auto move_distance = move_to_index - movable_begin_index;
+
+                for (auto i = size() - 1 - move_distance; i >= movable_begin_index; i--) {
+                    set_slot_activity(i + move_distance, _data[i].activity);
+                }
+
+                changed_bounds = bounds{movable_begin_index, size() - 1};
+            }
         } else {
-            auto movable_rbegin = from_index >= _data.size()
-                                      ? _data.rbegin()
-                                      : std::find_if(_data.rbegin() + (_data.size() - 1 - from_index),
-                                                     std::next(_data.rbegin() + (_data.size() - 1 - till_index)),
-                                                     activities_not_equal);
-
-            if (movable_rbegin != _data.rend()) {
-                auto movable_last_index = std::distance(movable_rbegin, _data.rend()) - 1;
-                auto move_to_index = till_index - 1;
-
-                if (move_to_index >= 0) {
-                    auto move_distance = movable_last_index - move_to_index;
-                    auto movable_begin_index = move_distance;
-
-                    for (auto i = movable_begin_index; i <= movable_last_index; i++) {
-                        result[i - move_distance].activity = _data[i].activity;
-                    }
+            // The last slot in the range with a different activity,
+            // and everything above it is pushed up.
+            auto movable_last_index = std::min(from_index, size() - 1);
+            auto movable_first_index = std::max(till_index, 0);
+
+            if (from_index < size()) {
+                while (movable_last_index >= movable_first_index &&
+                       _data[movable_last_index].activity == source_activity) {
+                    movable_last_index--;
+                }
+            }
+
+            auto move_to_index = till_index - 1;
+            if (move_to_index >= 0 && move_to_index < movable_last_index) {
+                auto move_distance = movable_last_index - move_to_index;
+
+                for (auto i = move_distance; i <= movable_last_index; i++) {
+                    set_slot_activity(i - move_distance, _data[i].activity);
                 }
+
+                changed_bounds = bounds{0, movable_last_index};
             }
         }
 
@@ -229,24 +209,40 @@ namespace stg {
             std::swap(till_index, from_index);
 
         for (auto i = from_index; i <= till_index; i++) {
-            result[i].activity = source_activity;
+            set_slot_activity(i, source_activity);
         }
 
-        _data = result;
+        changed_bounds = changed_bounds.merged(bounds{from_index, till_index});
 
         on_change_event();
+
+        return changed_bounds;
     }
 
 
-    void time_slots_state::silently_set_activity_at_index(index_t slot_index, activity *activity) {
+    void time_slots_state::silently_set_activity_at_index(index_t slot_index, activity_id activity) {
         if (!has_index(slot_index)) {
             return;
         }
 
-        _data[slot_index].activity = activity;
+        set_slot_activity(slot_index, activity);
     }
 
-    void time_slots_state::set_activity_at_indices(activity *activity,
+    void time_slots_state::set_slot_activity(index_t slot_index, activity_id activity) {
+        auto &slot = _data[slot_index];
+        if (slot.activity == activity)
+            return;
+
+        _content_hash -= list_item_hash(slot_index, slot.content_hash());
+        slot.activity = activity;
+        _content_hash += list_item_hash(slot_index, slot.content_hash());
+
+        _version = ++last_version;
+        unsynced_bounds = unsynced_bounds.merged(bounds{slot_index, slot_index});
+        unsnapshotted_bounds = unsnapshotted_bounds.merged(bounds{slot_index, slot_index});
+    }
+
+    void time_slots_state::set_activity_at_indices(activity_id activity,
                                                    const std::vector<index_t> &indices) {
         auto activity_changed = false;
         for (auto slot_index : indices) {
@@ -266,7 +262,7 @@ namespace stg {
     }
 
 
-    void time_slots_state::silently_set_activity_at_indices(activity *activity,
+    void time_slots_state::silently_set_activity_at_indices(activity_id activity,
                                                             const std::vector<index_t> &indices) {
         for (auto slot_index : indices) {
             silently_set_activity_at_index(slot_index, activity);
@@ -292,26 +288,33 @@ namespace stg {
         return global_begin_time + slot_index * _slot_duration;
     }
 
-    auto time_slots_state::has_activity(const activity *activity) const -> bool {
+    auto time_slots_state::has_activity(activity_id activity) const -> bool {
         return std::find_if(_data.begin(), _data.end(), [activity](const auto &time_slot) {
                    return time_slot.activity == activity;
                }) != _data.end();
     }
 
-    void time_slots_state::remove_activity(activity *activity) {
-        edit_activity(activity, time_slot::no_activity);
+    void time_slots_state::remove_activity(activity_id activity) {
+        replace_activity(activity, time_slot::no_activity);
     }
 
-    void time_slots_state::edit_activity(activity *old_activity,
-                                         activity *new_activity) {
+    void time_slots_state::replace_activity(activity_id old_activity,
+                                            activity_id new_activity) {
         auto activity_changed = false;
-        for (auto &time_slot : _data) {
-            if (time_slot.activity == old_activity) {
+        for (auto slot_index = 0; slot_index < size(); slot_index++) {
+            if (_data[slot_index].activity == old_activity) {
                 activity_changed = old_activity != new_activity;
-                time_slot.activity = new_activity;
+                set_slot_activity(slot_index, new_activity);
             }
         }
 
+        // Activity might also be outside of the slots' time window.
+        auto new_runs = *runs;
+        if (new_runs.replace_activity(old_activity, new_activity)) {
+            runs = std::make_shared<const activity_runs>(std::move(new_runs));
+            _version = ++last_version;
+        }
+
         if (activity_changed) {
             on_change_event();
         }
@@ -325,6 +328,12 @@ namespace stg {
         _begin_time = new_state._begin_time;
         _slot_duration = new_state._slot_duration;
 
+        new_state.sync_runs();
+        runs = new_state.runs;
+        unsynced_bounds = bounds();
+
+        update_content_hash();
+
         on_change_event();
 
         return *this;
@@ -338,6 +347,7 @@ namespace stg {
         _data.resize(actual_number_of_slots, time_slot(0, 0));
 
         update_begin_times();
+        rehash();
 
         on_change_event();
     }
@@ -353,13 +363,9 @@ namespace stg {
         if (destination_end_index > _data.size() - 1)
             destination_end_index = (index_t) _data.size() - 1;
 
-        auto index_in_copied = 0;
-        std::for_each(_data.begin() + destination_index,
-                      _data.begin() + destination_end_index,
-                      [&index_in_copied, copied_slots](auto &slot) {
-                          slot.activity = copied_slots[index_in_copied].activity;
-                          index_in_copied++;
-                      });
+        for (auto i = destination_index; i < destination_end_index; i++) {
+            set_slot_activity(i, copied_slots[i - destination_index].activity);
+        }
 
         on_change_event();
     }
@@ -371,10 +377,10 @@ namespace stg {
 
     void time_slots_state::silently_swap(index_t first_index,
                                          index_t second_index) {
-        auto *activity = _data[first_index].activity;
+        auto activity = _data[first_index].activity;
 
-        _data[first_index].activity = _data[second_index].activity;
-        _data[second_index].activity = activity;
+        set_slot_activity(first_index, _data[second_index].activity);
+        set_slot_activity(second_index, activity);
     }
 
     auto time_slots_state::at(index_t index) -> const time_slot & {
@@ -400,6 +406,134 @@ namespace stg {
     void time_slots_state::reset_with(data_t raw_data) {
         time_slots_state_base::reset_with(raw_data);
         reset_times();
+
+        reset_runs();
+        update_content_hash();
+    }
+
+    // Slots get the snapshot's version, if it has one,
+    // since they're the same as the ones the snapshot was made of.
+    // Slots of a projected snapshot are projected again from its runs.
+    void time_slots_state::reset_with(const time_slots_snapshot &snapshot) {
+        snapshot.copy_to(_data);
+        last_snapshot = snapshot;
+        unsnapshotted_bounds = bounds();
+
+        reset_times();
+
+        if (snapshot.runs()) {
+            runs = snapshot.runs();
+            unsynced_bounds = bounds();
+        } else {
+            reset_runs();
+        }
+
+        _content_hash = snapshot.content_hash();
+        _version = snapshot.version() != 0
+                       ? snapshot.version()
+                       : ++last_version;
+
+        if (snapshot.is_projected())
+            projected_version = _version;
+    }
+
+    auto time_slots_state::version() const -> version_t {
+        return _version;
+    }
+
+    auto time_slots_state::content_hash() const -> content_hash_t {
+        return _content_hash;
+    }
+
+    auto time_slots_state::snapshot() const -> time_slots_snapshot {
+        sync_runs();
+
+        if (last_snapshot.version() == _version)
+            return last_snapshot;
+
+        if (projected_version == _version) {
+            last_snapshot = time_slots_snapshot::projected(_begin_time,
+                                                           _slot_duration,
+                                                           size(),
+                                                           _version,
+                                                           _content_hash,
+                                                           runs);
+        } else {
+            last_snapshot = last_snapshot.updated(_data,
+                                                  unsnapshotted_bounds.start_index,
+                                                  unsnapshotted_bounds.end_index,
+                                                  _version,
+                                                  _content_hash,
+                                                  runs);
+        }
+
+        unsnapshotted_bounds = bounds();
+
+        return last_snapshot;
+    }
+
+    auto time_slots_state::differs_from(const time_slots_snapshot &snapshot) const -> bool {
+        if (snapshot.version() == _version)
+            return false;
+
+        if (snapshot.content_hash() != _content_hash || snapshot.size() != size())
+            return true;
+
+        return this->snapshot() != snapshot;
+    }
+
+    void time_slots_state::rehash() {
+        update_content_hash();
+
+        if (!empty())
+            unsynced_bounds = bounds{0, size() - 1};
+    }
+
+    // Slots are replaced as a whole whenever the hash is recalculated.
+    void time_slots_state::update_content_hash() {
+        _content_hash = time_slots_snapshot::content_hash_of(_data);
+        _version = ++last_version;
+
+        if (!empty())
+            unsnapshotted_bounds = bounds{0, size() - 1};
+    }
+
+    auto time_slots_state::runs_data() const -> const std::vector<activity_runs::run> & {
+        sync_runs();
+        return runs->data();
+    }
+
+    void time_slots_state::sync_runs() const {
+        if (unsynced_bounds.empty())
+            return;
+
+        auto new_runs = *runs;
+        new_runs.assign(_data, unsynced_bounds.start_index, unsynced_bounds.end_index);
+
+        runs = std::make_shared<const activity_runs>(std::move(new_runs));
+        unsynced_bounds = bounds();
+    }
+
+    void time_slots_state::reset_runs() {
+        runs = std::make_shared<const activity_runs>(_data);
+        unsynced_bounds = bounds();
+    }
+
+    void time_slots_state::project_runs(size_t number_of_slots) {
+        sync_runs();
+
+        _data.resize(number_of_slots, time_slot(0, _slot_duration));
+
+        for (auto slot_index = 0; slot_index < number_of_slots; slot_index++) {
+            auto &slot = _data[slot_index];
+            slot.begin_time = make_slot_begin_time(_begin_time, slot_index);
+            slot.duration = _slot_duration;
+        }
+
+        runs->project(_data);
+
+        update_content_hash();
+        projected_version = _version;
     }
 
     auto time_slots_state::make_ruler_times() const -> std::vector<std::time_t> {
@@ -426,25 +560,6 @@ namespace stg {
             index = size() - 1;
     }
 
-    auto time_slots_state::first_activity_in_time_window(minutes begin_time,
-                                                         minutes end_time) const -> activity * {
-        assert(end_time >= begin_time && "end_time must be greater than begin_time");
-
-        auto range = end_time - begin_time;
-
-        auto it = std::find_if(_data.begin(), _data.end(), [=](const time_slot &slot) {
-            auto slot_overlaps_with_range = slot.begin_time >= begin_time && slot.end_time() >= begin_time;
-
-            auto found = range >= slot_duration()
-                             ? (slot.begin_time >= begin_time && slot.end_time() <= end_time) || slot_overlaps_with_range
-                             : (slot.begin_time <= begin_time && slot.end_time() >= end_time) || slot_overlaps_with_range;
-
-            return found;
-        });
-
-        return it != _data.end() ? it->activity : nullptr;
-    }
-
     auto time_slots_state::slots_in_time_window(minutes begin_time,
                                                 minutes end_time) -> std::vector<time_slot *> {
         assert(end_time >= begin_time && "end_time must be greater than begin_time");
@@ -473,7 +588,7 @@ namespace stg {
     }
 
     void time_slots_state::on_change_event() const {
-        if (_ruler_times.empty() && !on_ruler_change) {
+        if (_ruler_times.empty() && on_ruler_change.empty()) {
             notifiable_on_change::on_change_event();
 
             return;
@@ -488,7 +603,7 @@ namespace stg {
 
         notifiable_on_change::on_change_event();
 
-        if (times_changed && on_ruler_change)
+        if (times_changed)
             on_ruler_change();
     }
 
@@ -500,21 +615,29 @@ namespace stg {
         return _ruler_times;
     }
 
-    void time_slots_state::add_on_ruler_change_callback(const std::function<void()> &callback) const {
-        auto old_on_ruler_change = on_ruler_change;
-
-        on_ruler_change = [=] {
-            if (old_on_ruler_change)
-                old_on_ruler_change();
-
-            callback();
-        };
+    auto time_slots_state::add_on_ruler_change_callback(const std::function<void()> &callback) const -> connection {
+        return on_ruler_change.connect(callback);
     }
 
-    auto time_slots_state::duration_for_activity(const activity *activity) const -> minutes {
+    auto time_slots_state::duration_for_activity(activity_id activity) const -> minutes {
         return std::accumulate(_data.begin(), _data.end(), 0, [activity](minutes duration, const time_slot &time_slot) {
             auto duration_in_slot = time_slot.activity == activity ? time_slot.duration : 0;
             return duration + duration_in_slot;
         });
     }
+
+    auto time_slots_state::bounds::empty() const -> bool {
+        return end_index < start_index;
+    }
+
+    auto time_slots_state::bounds::merged(const bounds &other) const -> bounds {
+        if (empty())
+            return other;
+
+        if (other.empty())
+            return *this;
+
+        return bounds{std::min(start_index, other.start_index),
+                      std::max(end_index, other.end_index)};
+    }
 }
@@ -11,6 +11,7 @@
 #include "privatelist.h"
 #include "streamablelist.h"
 #include "timeslot.h"
+#include "timeslotssnapshot.h"
 
 namespace stg {
     class strategy;
@@ -25,6 +26,15 @@ namespace stg {
         using minutes = time_slot::minutes;
         using size_t = int;
 
+        // Range of slots an operation might have changed, both ends are inclusive.
+        struct bounds {
+            index_t start_index = 0;
+            index_t end_index = -1;
+
+            auto empty() const -> bool;
+            auto merged(const bounds &other) const -> bounds;
+        };
+
         auto next_slot_empty(index_t index) const -> bool;
         auto previous_slot_empty(index_t index) const -> bool;
 
@@ -33,12 +43,31 @@ namespace stg {
         auto slot_duration() const -> minutes;
         auto number_of_slots() const -> size_t;
 
-        auto has_activity(const activity *activity) const -> bool;
-        auto duration_for_activity(const activity *activity) const -> minutes;
+        auto has_activity(activity_id activity) const -> bool;
+        auto duration_for_activity(activity_id activity) const -> minutes;
 
         auto ruler_times() const -> const std::vector<std::time_t> &;
 
-        void add_on_ruler_change_callback(const std::function<void()> &callback) const;
+        using version_t = time_slots_snapshot::version_t;
+
+        // Version changes with every modification of slots.
+        // Equal versions mean equal slots, even across different states.
+        auto version() const -> version_t;
+        auto content_hash() const -> content_hash_t;
+
+        // Shares unchanged pages with the previous snapshot,
+        // so taking a snapshot doesn't copy slots that haven't changed since.
+        // Right after a time grid change only the grid and runs are kept.
+        auto snapshot() const -> time_slots_snapshot;
+
+        // Compares versions and hashes first,
+        // slots are only compared if hashes are equal.
+        auto differs_from(const time_slots_snapshot &snapshot) const -> bool;
+
+        // Activities in absolute minutes, including the ones outside of the slots' time window.
+        auto runs_data() const -> const std::vector<activity_runs::run> &;
+
+        auto add_on_ruler_change_callback(const std::function<void()> &callback) const -> connection;
 
     private:
         friend strategy;
@@ -49,7 +78,24 @@ namespace stg {
         minutes _slot_duration = 0;
 
         mutable std::vector<std::time_t> _ruler_times;
-        mutable std::function<void()> on_ruler_change = nullptr;
+        mutable time_slots_snapshot last_snapshot;
+
+        static inline version_t last_version = 0;
+
+        version_t _version = 0;
+        content_hash_t _content_hash = 0;
+        signal<> on_ruler_change;
+
+        // Slots are projected from runs when the time grid changes.
+        // Runs are brought up to date with slots changed since the last sync lazily.
+        mutable time_slots_snapshot::runs_ptr runs = nullptr;
+        mutable bounds unsynced_bounds;
+
+        // Version of the slots last projected from runs.
+        version_t projected_version = 0;
+
+        // Slots changed since the last snapshot, only their pages are made again.
+        mutable bounds unsnapshotted_bounds;
 
         time_slots_state(minutes start_time,
                          minutes slot_duration,
@@ -66,27 +112,27 @@ namespace stg {
         void set_slot_duration(minutes slot_duration);
         void set_number_of_slots(size_t new_number_of_slots);
         void set_end_time(minutes end_time);
-        void set_activity_at_indices(activity *activity,
+        void set_activity_at_indices(activity_id activity,
                                      const std::vector<index_t> &indices);
 
-        void silently_set_activity_at_indices(activity *activity, const std::vector<index_t> &indices);
-        void silently_set_activity_at_index(index_t slot_index, activity *activity);
-        void silently_fill_slots(index_t from_index, index_t till_index);
-        void fill_slots(index_t from_index, index_t till_index);
-        void fill_slots_shifting(index_t from_index, index_t till_index);
+        void silently_set_activity_at_indices(activity_id activity, const std::vector<index_t> &indices);
+        void silently_set_activity_at_index(index_t slot_index, activity_id activity);
+        void set_slot_activity(index_t slot_index, activity_id activity);
+        auto silently_fill_slots(index_t from_index, index_t till_index) -> bounds;
+        auto fill_slots(index_t from_index, index_t till_index) -> bounds;
+        auto fill_slots_shifting(index_t from_index, index_t till_index) -> bounds;
         void shift_below(index_t from_index, size_t length);
         void copy_slots(index_t from_index, index_t till_index, index_t destination_index);
         void populate(minutes start_time, size_t number_of_slots);
 
-        void remove_activity(activity *activity);
-        void edit_activity(activity *old_activity, activity *new_activity);
+        void remove_activity(activity_id activity);
+        void replace_activity(activity_id old_activity, activity_id new_activity);
 
         void swap(index_t first_index, index_t second_index);
         void silently_swap(index_t first_index, index_t second_index);
 
         auto at(index_t index) -> const time_slot &;
 
-        auto first_activity_in_time_window(minutes begin_time, minutes end_time) const -> activity *;
         auto slots_in_time_window(time_slots_state::minutes begin_time,
                                   time_slots_state::minutes end_time) -> std::vector<time_slot *>;
 
@@ -94,8 +140,20 @@ namespace stg {
         void update_begin_times();
         void reset_times();
 
+        // Must be called after slots are changed other than by set_slot_activity().
+        void rehash();
+        void update_content_hash();
+
+        void sync_runs() const;
+        void reset_runs();
+
+        // Resizes slots for the current begin time and slot duration,
+        // and sets their activities from runs.
+        void project_runs(size_t number_of_slots);
+
         void make_safe_index(index_t &index);
         void reset_with(data_t raw_data) override;
+        void reset_with(const time_slots_snapshot &snapshot);
 
         auto make_ruler_times() const -> std::vector<std::time_t>;
 
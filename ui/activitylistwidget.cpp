@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include <QAction>
 #include <QLabel>
 #include <QLayout>
@@ -10,13 +12,15 @@
 #include "activityinvalidpropertyexception.h"
 #include "activitylistwidget.h"
 #include "activitywidget.h"
+#include "applicationsettings.h"
+#include "instrumentation.h"
 #include "mainscene.h"
 #include "mainwindow.h"
 #include "searchboxwidget.h"
 #include "slotboardwidget.h"
 
 ActivityListWidget::ActivityListWidget(QWidget *parent) : DataProviderWidget(parent) {
-    strategy().activities().add_on_change_callback(this, &ActivityListWidget::updateUI);
+    activitiesConnection = strategy().activities().add_on_change_callback(this, &ActivityListWidget::updateUI);
 
     setLayout(new QVBoxLayout());
     layout()->setSpacing(0);
@@ -79,6 +83,11 @@ void ActivityListWidget::layoutChildWidgets() {
                               " }");
     scrollArea->setWidget(listWidget);
 
+    connect(scrollArea->verticalScrollBar(),
+            &QScrollBar::valueChanged,
+            this,
+            &ActivityListWidget::updateVisibleRows);
+
     searchBox = new SearchBoxWidget("Find...");
     connect(searchBox,
             &SearchBoxWidget::textEdited,
@@ -116,22 +125,72 @@ void ActivityListWidget::layoutChildWidgets() {
             });
 }
 
-void ActivityListWidget::setSelectedForItemAtIndex(int index, bool isSelected) const {
-    auto listItem = qobject_cast<ActivityWidget *>(
-        listWidget->layout()->itemAt(index)->widget());
-
+void ActivityListWidget::setSelectedForItemAtIndex(int index, bool isSelected) {
+    auto *listItem = itemWidgetForRow(index);
     if (listItem)
         listItem->setIsSelected(isSelected);
 }
 
 void ActivityListWidget::deselectAllItems() {
-    for (size_t i = 0; i < numberOfItems(); i++) {
-        setSelectedForItemAtIndex(i, false);
+    for (auto index = 0; index < visibleRowsCount; index++) {
+        setSelectedForItemAtIndex(firstVisibleRowIndex + index, false);
     }
 
     selectedActivityIndex = -1;
 }
 
+int ActivityListWidget::rowHeight() {
+    return ApplicationSettings::defaultActivityItemHeight;
+}
+
+int ActivityListWidget::numberOfRows() {
+    return static_cast<int>(strategy().activities().filtered().size());
+}
+
+std::pair<int, int> ActivityListWidget::rowsRangeInViewport() {
+    auto viewportTop = scrollArea->verticalScrollBar()->value();
+    auto viewportBottom = viewportTop + scrollArea->viewport()->height();
+
+    auto first = std::max(0, viewportTop / rowHeight() - overscanRowsCount);
+    auto last = std::min(numberOfRows(), viewportBottom / rowHeight() + 1 + overscanRowsCount);
+
+    first = std::min(first, last);
+
+    return {first, last};
+}
+
+ActivityWidget *ActivityListWidget::itemWidgetForRow(int row) {
+    auto index = row - firstVisibleRowIndex;
+    if (index < 0 || index >= visibleRowsCount)
+        return nullptr;
+
+    return listItemWidgetAtIndex(index);
+}
+
+void ActivityListWidget::updateVisibleRows() {
+    auto [first, last] = rowsRangeInViewport();
+    if (first == firstVisibleRowIndex && last - first == visibleRowsCount)
+        return;
+
+    updateRows();
+}
+
+void ActivityListWidget::updateRows() {
+    auto [first, last] = rowsRangeInViewport();
+
+    firstVisibleRowIndex = first;
+    visibleRowsCount = last - first;
+
+    // Margins keep the list's height, so the scroll bar stays the same.
+    listLayout()->setContentsMargins(0,
+                                     first * rowHeight(),
+                                     0,
+                                     (numberOfRows() - last) * rowHeight());
+
+    // Widgets of rows that stay visible are kept as they are.
+    updateList();
+}
+
 void ActivityListWidget::setupNavbar() {
     navbar = new Navbar();
     layout()->addWidget(navbar);
@@ -158,27 +217,31 @@ void ActivityListWidget::getBack() {
     actionCenter().show_sessions();
 }
 
-void ActivityListWidget::reconnectItemAtIndex(int itemIndex,
-                                              ActivityWidget *item) {
-    item->disconnect();
-
-    auto activityIndex = *strategy().activities().index_from_filtered(itemIndex);
+void ActivityListWidget::connectItem(ActivityWidget *item) {
+    // Items are reused for other activities and move around the list,
+    // so indices are looked up when signals are emitted.
+    auto activityIndex = [=]() {
+        return strategy().activities().index_of(item->activityId());
+    };
 
     connect(item, &ActivityWidget::selected, [=] {
-        actionCenter().place_activity_in_selection(activityIndex);
+        if (auto index = activityIndex())
+            actionCenter().place_activity_in_selection(*index);
     });
 
     connect(item, &ActivityWidget::activityDeleted, [=] {
-        strategy().delete_activity(activityIndex);
+        if (auto index = activityIndex())
+            strategy().delete_activity(*index);
     });
 
     connect(item, &ActivityWidget::activityEdited, [=](const stg::activity &newActivity) {
-        strategy().edit_activity(activityIndex, newActivity);
+        if (auto index = activityIndex())
+            strategy().edit_activity(*index, newActivity);
     });
 
     connect(item, &ActivityWidget::hovered, [=] {
         deselectAllItems();
-        removeBorderBeforeIndex(itemIndex);
+        removeBorderBeforeIndex(listLayout()->indexOf(item));
     });
 
     connect(item, &ActivityWidget::unhovered, [=] {
@@ -191,7 +254,7 @@ void ActivityListWidget::performSearch() {
     auto needsToUpdateList = strategy().activities().search(searchQuery);
 
     if (needsToUpdateList) {
-        updateList();
+        updateRows();
         deselectAllItems();
     }
 }
@@ -215,29 +278,39 @@ void ActivityListWidget::showNewActivityMenu() {
 }
 
 void ActivityListWidget::reloadStrategy() {
+    auto timing = stg::instrumentation::scope("ActivityListWidget::reloadStrategy");
+
     updateUI();
 }
 
 int ActivityListWidget::numberOfItems() {
-    return strategy().activities().filtered().size();
+    return visibleRowsCount;
 }
 
 QVBoxLayout *ActivityListWidget::listLayout() {
     return qobject_cast<QVBoxLayout *>(listWidget->layout());
 }
 
+stg::activity_id ActivityListWidget::keyForItemAtIndex(int index) {
+    return strategy().activities().filtered().at(firstVisibleRowIndex + index);
+}
+
 void ActivityListWidget::reuseItemAtIndex(int index, ActivityWidget *itemWidget) {
-    auto activity = strategy().activities().filtered().at(index).get();
+    auto row = firstVisibleRowIndex + index;
+    auto activityId = strategy().activities().filtered().at(row);
 
-    itemWidget->setActivity(activity);
-    reconnectItemAtIndex(index, itemWidget);
+    // Only updates the widget if the activity or its usage has changed.
+    itemWidget->setActivity(activityId);
+    itemWidget->setIsSelected(row == selectedActivityIndex);
 }
 
 ActivityWidget *ActivityListWidget::makeNewItemAtIndex(int index) {
-    auto activity = strategy().activities().filtered().at(index).get();
+    auto row = firstVisibleRowIndex + index;
+    auto activityId = strategy().activities().filtered().at(row);
 
-    auto itemWidget = new ActivityWidget(activity, this);
-    reconnectItemAtIndex(index, itemWidget);
+    auto itemWidget = new ActivityWidget(activityId, this);
+    itemWidget->setIsSelected(row == selectedActivityIndex);
+    connectItem(itemWidget);
     return itemWidget;
 }
 
@@ -256,7 +329,9 @@ void ActivityListWidget::removeBorderBeforeIndex(int index) {
 }
 
 void ActivityListWidget::updateUI() {
-    updateList();
+    auto timing = stg::instrumentation::scope("ActivityListWidget::updateUI");
+
+    updateRows();
 
     if (strategy().activities().empty()) {
         scrollArea->hide();
@@ -284,8 +359,7 @@ bool ActivityListWidget::eventFilter(QObject *object, QEvent *event) {
             return true;
         } else if (keyEvent->key() == Qt::Key_Return ||
                    keyEvent->key() == Qt::Key_Enter) {
-            if (selectedActivityIndex >= 0) {
-                auto itemWidget = listItemWidgetAtIndex(selectedActivityIndex);
+            if (auto *itemWidget = itemWidgetForRow(selectedActivityIndex)) {
                 itemWidget->choose(nullptr);
             }
 
@@ -293,6 +367,8 @@ bool ActivityListWidget::eventFilter(QObject *object, QEvent *event) {
         }
     } else if (object == scrollArea && isKeyPressEvent) {
         return true;
+    } else if (object == scrollArea && event->type() == QEvent::Resize) {
+        updateVisibleRows();
     }
 
     return false;
@@ -310,24 +386,22 @@ void ActivityListWidget::selectUp() {
 
     selectedActivityIndex = oldSelectedIndex - 1;
 
-    if (selectedActivityIndex >= 0 && selectedActivityIndex < numberOfItems()) {
+    if (selectedActivityIndex >= 0 && selectedActivityIndex < numberOfRows()) {
         setSelectedForItemAtIndex(selectedActivityIndex, true);
         scrollUpItemIntoViewAtIndex(selectedActivityIndex);
     }
 }
 
 void ActivityListWidget::scrollUpItemIntoViewAtIndex(int index) {
-    auto *selectedWidget = listItemWidgetAtIndex(index);
-    if (selectedWidget->geometry().top() < scrollArea->verticalScrollBar()->value()) {
-        auto newScrollTop = selectedWidget->geometry().top();
-
-        scrollArea->verticalScrollBar()->setValue(newScrollTop);
+    auto itemTop = index * rowHeight();
+    if (itemTop < scrollArea->verticalScrollBar()->value()) {
+        scrollArea->verticalScrollBar()->setValue(itemTop);
     }
 }
 
 void ActivityListWidget::selectDown() {
-    if (selectedActivityIndex >= numberOfItems() - 1) {
-        selectedActivityIndex = numberOfItems() - 1;
+    if (selectedActivityIndex >= numberOfRows() - 1) {
+        selectedActivityIndex = numberOfRows() - 1;
         return;
     }
 
@@ -337,7 +411,7 @@ void ActivityListWidget::selectDown() {
 
     selectedActivityIndex = oldSelectedIndex + 1;
 
-    if (selectedActivityIndex >= 0 && selectedActivityIndex < numberOfItems()) {
+    if (selectedActivityIndex >= 0 && selectedActivityIndex < numberOfRows()) {
         setSelectedForItemAtIndex(selectedActivityIndex, true);
 
         scrollDownItemIntoViewAtIndex(selectedActivityIndex);
@@ -345,11 +419,9 @@ void ActivityListWidget::selectDown() {
 }
 
 void ActivityListWidget::scrollDownItemIntoViewAtIndex(int index) {
-    auto *selectedWidget = listItemWidgetAtIndex(selectedActivityIndex);
-    if (selectedWidget->geometry().bottom() >
-        scrollArea->viewport()->height() + scrollArea->verticalScrollBar()->value()) {
-        auto newScrollTop = selectedWidget->geometry().bottom() -
-                            scrollArea->viewport()->height();
+    auto itemBottom = (index + 1) * rowHeight();
+    if (itemBottom > scrollArea->viewport()->height() + scrollArea->verticalScrollBar()->value()) {
+        auto newScrollTop = itemBottom - scrollArea->viewport()->height();
 
         scrollArea->verticalScrollBar()->setValue(newScrollTop);
     }
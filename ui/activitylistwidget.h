@@ -19,7 +19,7 @@ class QLineEdit;
 class QScrollArea;
 
 class ActivityListWidget : public DataProviderWidget,
-                           public ReactiveList<ActivityWidget>,
+                           public ReactiveList<ActivityWidget, stg::activity_id>,
                            public ColorProvider {
     Q_OBJECT
 public:
@@ -42,8 +42,18 @@ private:
 
     QAction *getBackAction = nullptr;
 
+    // Only rows intersecting the viewport have widgets,
+    // and the rest of the list is represented by the list layout's margins.
+    static const auto overscanRowsCount = 4;
+
+    int firstVisibleRowIndex = 0;
+    int visibleRowsCount = 0;
+
+    // Index of the selected row among all filtered activities.
     int selectedActivityIndex = -1;
 
+    stg::scoped_connection activitiesConnection;
+
     void layoutChildWidgets();
     void setupNavbar();
     void setupActions();
@@ -52,9 +62,17 @@ private:
 
     void performSearch();
 
-    void setSelectedForItemAtIndex(int index, bool isSelected) const;
+    void setSelectedForItemAtIndex(int index, bool isSelected);
     void deselectAllItems();
 
+    int rowHeight();
+    int numberOfRows();
+    std::pair<int, int> rowsRangeInViewport();
+    ActivityWidget *itemWidgetForRow(int row);
+
+    void updateVisibleRows();
+    void updateRows();
+
     void updateUI();
     void removeBorderBeforeIndex(int index);
 
@@ -63,10 +81,11 @@ private:
 
     // ReactiveList
     int numberOfItems() override;
+    stg::activity_id keyForItemAtIndex(int index) override;
     QVBoxLayout *listLayout() override;
     void reuseItemAtIndex(int index, ActivityWidget *itemWidget) override;
     ActivityWidget *makeNewItemAtIndex(int index) override;
-    void reconnectItemAtIndex(int itemIndex, ActivityWidget *item);
+    void connectItem(ActivityWidget *item);
 
     void scrollUpItemIntoViewAtIndex(int index);
     void scrollDownItemIntoViewAtIndex(int index);
@@ -15,8 +15,8 @@
 #include "time_utils.h"
 #include "utils.h"
 
-ActivityWidget::ActivityWidget(stg::activity *activity, QWidget *parent)
-    : DataProviderWidget(parent), _activity(activity) {
+ActivityWidget::ActivityWidget(stg::activity_id activityId, QWidget *parent)
+    : DataProviderWidget(parent), _activityId(activityId) {
     setFixedHeight(ApplicationSettings::defaultActivityItemHeight);
 
     setLayout(new QHBoxLayout());
@@ -107,7 +107,7 @@ void ActivityWidget::updateUI() {
     using namespace ColorUtils;
     using namespace stg::time_utils;
 
-    activityIsUsed = strategy().time_slots().has_activity(activity());
+    activityIsUsed = strategy().time_slots().has_activity(_activityId);
     titleLabel->setText(activity()->name().c_str());
 
     durationLabel->setText(human_string_from_minutes(duration).c_str());
@@ -116,19 +116,25 @@ void ActivityWidget::updateUI() {
     update();
 }
 
-stg::activity *ActivityWidget::activity() const {
-    return _activity;
+stg::activity_id ActivityWidget::activityId() const {
+    return _activityId;
 }
 
-void ActivityWidget::setActivity(stg::activity *activity) {
-    bool newActivityIsUsed = strategy().time_slots().has_activity(activity);
-    auto newDuration = strategy().time_slots().duration_for_activity(activity);
+const stg::activity *ActivityWidget::activity() const {
+    return strategy().activities().get(_activityId);
+}
+
+void ActivityWidget::setActivity(stg::activity_id activityId) {
+    bool newActivityIsUsed = strategy().time_slots().has_activity(activityId);
+    auto newDuration = strategy().time_slots().duration_for_activity(activityId);
+    auto newActivityHash = strategy().activities().get(activityId)->content_hash();
 
-    bool activityChanged = activity != _activity;
+    bool activityChanged = activityId != _activityId || newActivityHash != activityHash;
     bool activityIsUsedChanged = newActivityIsUsed != activityIsUsed;
     bool durationChanged = newDuration != duration;
 
-    _activity = activity;
+    _activityId = activityId;
+    activityHash = newActivityHash;
     activityIsUsed = newActivityIsUsed;
     duration = newDuration;
 
@@ -203,6 +209,9 @@ bool ActivityWidget::drawsBorder() const {
 }
 
 void ActivityWidget::setDrawsBorder(bool drawsBorder) {
+    if (drawsBorder == _drawsBorder)
+        return;
+
     _drawsBorder = drawsBorder;
     update();
 }
@@ -212,6 +221,9 @@ bool ActivityWidget::isSelected() const {
 }
 
 void ActivityWidget::setIsSelected(bool isSelected) {
+    if (isSelected == _isSelected)
+        return;
+
     _isSelected = isSelected;
     update();
 }
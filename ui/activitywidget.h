@@ -9,6 +9,7 @@
 
 #include "activity.h"
 #include "activityeditormenu.h"
+#include "activityid.h"
 #include "coloredlabel.h"
 #include "colorpicker.h"
 #include "colorprovider.h"
@@ -17,10 +18,11 @@
 class ActivityWidget : public DataProviderWidget, public ColorProvider {
     Q_OBJECT
 public:
-    explicit ActivityWidget(stg::activity *activity, QWidget *parent);
+    explicit ActivityWidget(stg::activity_id activityId, QWidget *parent);
 
-    stg::activity *activity() const;
-    void setActivity(stg::activity *activity);
+    stg::activity_id activityId() const;
+    const stg::activity *activity() const;
+    void setActivity(stg::activity_id activityId);
     bool drawsBorder() const;
     void setDrawsBorder(bool drawsBorder);
     bool isSelected() const;
@@ -39,7 +41,10 @@ signals:
 private:
     static constexpr int circleSize = 10;
 
-    stg::activity *_activity;
+    stg::activity_id _activityId;
+
+    // Activities are edited in place, so the hash tells if the activity has changed.
+    stg::content_hash_t activityHash = activity()->content_hash();
 
     ColoredLabel *titleLabel = nullptr;
     ColoredLabel *durationLabel = nullptr;
@@ -49,8 +54,8 @@ private:
     bool _isSelected = false;
     bool isClicked = false;
     bool _drawsBorder = true;
-    bool activityIsUsed = strategy().time_slots().has_activity(activity());
-    int duration = strategy().time_slots().duration_for_activity(activity());
+    bool activityIsUsed = strategy().time_slots().has_activity(_activityId);
+    int duration = strategy().time_slots().duration_for_activity(_activityId);
 
     void mousePressEvent(QMouseEvent *event) override;
     void mouseReleaseEvent(QMouseEvent *event) override;
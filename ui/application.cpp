@@ -7,6 +7,7 @@
 
 #include "application.h"
 #include "colorprovider.h"
+#include "instrumentationhud.h"
 
 #ifdef Q_OS_WIN
 
@@ -35,6 +36,7 @@ Application::Application(int &argc, char **argv)
     : QApplication(argc, argv) {
     currentSettings().setProperty("lastLaunchedVersion", ApplicationSettings::version);
 
+    InstrumentationHUD::enableIfRequested();
     setupFonts();
 
 #ifdef Q_OS_MAC
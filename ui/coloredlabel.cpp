@@ -24,8 +24,12 @@ const QString &ColoredLabel::text() const {
 }
 
 void ColoredLabel::setText(const QString &text) {
+    if (_text == text)
+        return;
+
     _text = text;
     updateGeometry();
+    update();
 }
 
 const Qt::Alignment &ColoredLabel::alignment() const {
@@ -65,6 +69,9 @@ void ColoredLabel::setBold(bool isBold) {
 }
 
 void ColoredLabel::setFontHeight(int fontHeight) {
+    if (font().pixelSize() == fontHeight)
+        return;
+
     auto newFont = QFont(font());
     newFont.setPixelSize(fontHeight);
 
@@ -74,6 +81,14 @@ void ColoredLabel::setFontHeight(int fontHeight) {
 
 
 void ColoredLabel::setDynamicColor(const std::function<QColor()> &newColorGetter) {
+    // Plain function getters can be compared, so that unchanged labels aren't repainted.
+    using ColorGetterPointer = QColor (*)();
+    auto *currentGetter = colorGetter.target<ColorGetterPointer>();
+    auto *newGetter = newColorGetter.target<ColorGetterPointer>();
+
+    if (currentGetter && newGetter && *currentGetter == *newGetter)
+        return;
+
     colorGetter = newColorGetter;
     update();
 }
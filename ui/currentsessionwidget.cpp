@@ -50,9 +50,15 @@ CurrentSessionWidget::CurrentSessionWidget(QWidget *parent) : DataProviderWidget
         if (!activeSession)
             return;
 
+        auto *activity = strategy().activities().get(activeSession->activity);
+        if (!activity)
+            return;
+
         FontUtils::drawSessionTitle(*activeSession,
+                                    *activity,
                                     *painter,
-                                    activityLabel->contentsRect());
+                                    activityLabel->contentsRect(),
+                                    activeSessionTitleLayout);
     };
 
     activityLabel->setAlignment(Qt::AlignTop | Qt::AlignHCenter);
@@ -161,6 +167,17 @@ void CurrentSessionWidget::paintEvent(QPaintEvent *event) {
     painter.drawRect(QRect(0, 0, width(), 1));
 }
 
+void CurrentSessionWidget::changeEvent(QEvent *event) {
+    // The title is laid out in the label's font.
+    if (event->type() == QEvent::FontChange ||
+        event->type() == QEvent::ApplicationFontChange) {
+        activeSessionTitleLayout = std::nullopt;
+        activityLabel->update();
+    }
+
+    DataProviderWidget::changeEvent(event);
+}
+
 void CurrentSessionWidget::mousePressEvent(QMouseEvent *) {
     isHovered = false;
     isClicked = true;
@@ -191,6 +208,7 @@ void CurrentSessionWidget::reloadStrategy() {
 void CurrentSessionWidget::slideAndHide(const std::function<void()> &onFinishedCallback) {
     SlidingAnimator::Options options;
     options.onFinishedCallback = onFinishedCallback;
+    options.animatesSnapshot = true;
     options.duration = ApplicationSettings::currentSessionShowDelay;
 
     SlidingAnimator::hideWidget(this, options);
@@ -199,6 +217,7 @@ void CurrentSessionWidget::slideAndHide(const std::function<void()> &onFinishedC
 void CurrentSessionWidget::slideAndShow(const std::function<void()> &onFinishedCallback) {
     SlidingAnimator::Options options;
     options.onFinishedCallback = onFinishedCallback;
+    options.animatesSnapshot = true;
     options.duration = ApplicationSettings::currentSessionShowDelay;
 
     SlidingAnimator::showWidget(this, options);
@@ -227,7 +246,11 @@ void CurrentSessionWidget::updateUIWithSession(const stg::session *activeSession
 
 QString CurrentSessionWidget::makeActivitySessionTitle() {
     const auto *activitySession = strategy().active_session();
-    return QString::fromStdString(stg::time_utils::human_string_from_minutes(activitySession->duration())) + " " + "<font color=\"" + QString::fromStdString(activitySession->activity->color()) + "\">" + QString::fromStdString(activitySession->activity->name()) + "</font>";
+    auto *activity = strategy().activities().get(activitySession->activity);
+    if (!activity)
+        return QString();
+
+    return QString::fromStdString(stg::time_utils::human_string_from_minutes(activitySession->duration())) + " " + "<font color=\"" + QString::fromStdString(activity->color()) + "\">" + QString::fromStdString(activity->name()) + "</font>";
 }
 
 double CurrentSessionWidget::progress() const { return _progress; }
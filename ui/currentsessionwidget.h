@@ -9,6 +9,7 @@
 
 #include "colorprovider.h"
 #include "dataproviderwidget.h"
+#include "fontutils.h"
 
 class ColoredLabel;
 class CurrentSessionWidget : public DataProviderWidget,
@@ -30,6 +31,7 @@ private:
     double _progress = 0.0;
 
     std::optional<stg::session> activeSession;
+    std::optional<FontUtils::SessionTitleLayout> activeSessionTitleLayout;
 
     ColoredLabel *activityLabel = nullptr;
     ColoredLabel *startTimeLabel = nullptr;
@@ -43,6 +45,7 @@ private:
     void updateUIWithSession(const stg::session *session);
 
     void paintEvent(QPaintEvent *event) override;
+    void changeEvent(QEvent *event) override;
     void mousePressEvent(QMouseEvent *event) override;
     void enterEvent(QEvent *event) override;
     void leaveEvent(QEvent *event) override;
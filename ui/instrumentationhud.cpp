@@ -0,0 +1,132 @@
+#include <algorithm>
+
+#include <QDir>
+#include <QFontDatabase>
+#include <QPainter>
+#include <QResizeEvent>
+#include <QtDebug>
+
+#include "instrumentationhud.h"
+
+void InstrumentationHUD::enableIfRequested() {
+    auto isRequested = !qEnvironmentVariableIsEmpty("STRATEGR_INSTRUMENTATION");
+    stg::instrumentation::set_enabled(isRequested);
+}
+
+QString InstrumentationHUD::dumpFilePath() {
+    auto path = qEnvironmentVariable("STRATEGR_INSTRUMENTATION_FILE");
+    if (!path.isEmpty())
+        return path;
+
+    return QDir::temp().filePath("strategr-instrumentation.tsv");
+}
+
+InstrumentationHUD::InstrumentationHUD(QWidget *parent) : QWidget(parent) {
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+
+    refreshTimer = new QTimer(this);
+    refreshTimer->setInterval(refreshInterval);
+    connect(refreshTimer, &QTimer::timeout, this, &InstrumentationHUD::refresh);
+    refreshTimer->start();
+
+    dumpAction = new QAction(tr("Dump Instrumentation"), this);
+    dumpAction->setShortcut(QKeySequence(Qt::CTRL + Qt::ALT + Qt::SHIFT + Qt::Key_I));
+    dumpAction->setShortcutContext(Qt::WindowShortcut);
+    connect(dumpAction, &QAction::triggered, this, &InstrumentationHUD::dumpToFile);
+    parent->addAction(dumpAction);
+
+    parent->installEventFilter(this);
+
+    lines = makeLines();
+    updateGeometryInParent();
+    raise();
+    show();
+}
+
+InstrumentationHUD::~InstrumentationHUD() {
+    dumpToFile();
+}
+
+void InstrumentationHUD::dumpToFile() {
+    auto path = dumpFilePath();
+
+    try {
+        stg::instrumentation::write_to_file(path.toStdString());
+    } catch (const stg::instrumentation::file_write_exception &) {
+        qWarning() << "Can't write instrumentation statistics to" << path;
+    }
+}
+
+QString InstrumentationHUD::makeLine(const QString &name, const QString &p50, const QString &p99) {
+    return QString("%1 %2 %3").arg(name, -36).arg(p50, 8).arg(p99, 8);
+}
+
+QStringList InstrumentationHUD::makeLines() {
+    // Sections are shown from the slowest to the fastest.
+    auto summaries = stg::instrumentation::summaries();
+    std::sort(summaries.begin(), summaries.end(), [](auto &lhs, auto &rhs) {
+        return lhs.p99 > rhs.p99;
+    });
+
+    if (summaries.size() > maxRowsCount)
+        summaries.resize(maxRowsCount);
+
+    auto result = QStringList{makeLine("section", "p50 ms", "p99 ms")};
+    for (const auto &summary : summaries) {
+        result.append(makeLine(QString::fromStdString(summary.name).left(36),
+                               QString::number(summary.p50, 'f', 2),
+                               QString::number(summary.p99, 'f', 2)));
+    }
+
+    return result;
+}
+
+void InstrumentationHUD::refresh() {
+    auto newLines = makeLines();
+    if (newLines == lines)
+        return;
+
+    lines = std::move(newLines);
+
+    updateGeometryInParent();
+    raise();
+    update();
+}
+
+void InstrumentationHUD::updateGeometryInParent() {
+    auto lineHeight = fontMetrics().height();
+    auto height = static_cast<int>(lines.size()) * lineHeight + lineHeight / 2;
+    auto width = std::min(parentWidget()->width(), 60 * fontMetrics().averageCharWidth());
+
+    setGeometry(parentWidget()->width() - width,
+                parentWidget()->height() - height,
+                width,
+                height);
+}
+
+bool InstrumentationHUD::eventFilter(QObject *object, QEvent *event) {
+    if (object == parentWidget() && event->type() == QEvent::Resize)
+        updateGeometryInParent();
+
+    return false;
+}
+
+void InstrumentationHUD::paintEvent(QPaintEvent *) {
+    auto painter = QPainter(this);
+
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor(30, 30, 30));
+    painter.drawRect(rect());
+
+    auto lineHeight = fontMetrics().height();
+    auto textRect = rect().adjusted(lineHeight / 4, lineHeight / 4, -lineHeight / 4, 0);
+
+    painter.setPen(Qt::white);
+
+    for (const auto &line : lines) {
+        painter.drawText(textRect, Qt::AlignLeft | Qt::AlignTop, line);
+        textRect.translate(0, lineHeight);
+    }
+}
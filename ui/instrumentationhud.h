@@ -0,0 +1,47 @@
+#ifndef STRATEGR_INSTRUMENTATIONHUD_H
+#define STRATEGR_INSTRUMENTATIONHUD_H
+
+#include <QAction>
+#include <QStringList>
+#include <QTimer>
+#include <QWidget>
+
+#include "instrumentation.h"
+
+// Overlay showing rolling p50/p99 durations of instrumented sections.
+// It's opaque and only repaints when the shown numbers change,
+// so its own repaints don't make widgets under it paint and add samples.
+// Instrumentation is enabled by setting STRATEGR_INSTRUMENTATION environment variable.
+// Statistics are written to STRATEGR_INSTRUMENTATION_FILE (or a file in the temp directory)
+// on Ctrl+Alt+Shift+I and when the window is closed.
+class InstrumentationHUD : public QWidget {
+    Q_OBJECT
+public:
+    static void enableIfRequested();
+
+    explicit InstrumentationHUD(QWidget *parent);
+    ~InstrumentationHUD() override;
+
+    static QString dumpFilePath();
+    void dumpToFile();
+
+private:
+    static const auto refreshInterval = 500;
+    static const auto maxRowsCount = 24;
+
+    QTimer *refreshTimer = nullptr;
+    QAction *dumpAction = nullptr;
+
+    QStringList lines;
+
+    static QString makeLine(const QString &name, const QString &p50, const QString &p99);
+    static QStringList makeLines();
+
+    void refresh();
+    void updateGeometryInParent();
+
+    bool eventFilter(QObject *object, QEvent *event) override;
+    void paintEvent(QPaintEvent *) override;
+};
+
+#endif//STRATEGR_INSTRUMENTATIONHUD_H
@@ -38,7 +38,8 @@ private:
     stg::action_center _action_center = stg::action_center(
         _strategy,
         [] { return ApplicationSettings::defaultSlotHeight; },
-        [this] { return scrollboardScrollArea()->viewportRectRelativeToContent(); });
+        [this] { return scrollboardScrollArea()->viewportRectRelativeToContent(); },
+        [this] { return devicePixelRatioF(); });
     SessionsMainWidget *sessionsMainWidget;
     ActivityListWidget *activitiesWidget;
 };
@@ -9,6 +9,7 @@
 #include "alert.h"
 #include "application.h"
 #include "applicationmenu.h"
+#include "instrumentationhud.h"
 #include "macoswindow.h"
 #include "mainscene.h"
 #include "mainwindow.h"
@@ -44,13 +45,22 @@ void MainWindow::setup() {
     MacOSWindow::setup(this);
 #endif
 
-    strategy.add_on_change_callback(this, &MainWindow::strategyStateChanged);
+    // Widgets reload once per event loop turn, however many changes a single action makes.
+    // Time slots and selection stay immediate, since the model itself depends on them.
+    strategy.set_dispatch_mode(stg::notifiable_on_change::dispatch_mode::deferred);
+    strategy.sessions().set_dispatch_mode(stg::notifiable_on_change::dispatch_mode::deferred);
+    strategy.activities().set_dispatch_mode(stg::notifiable_on_change::dispatch_mode::deferred);
+
+    strategyConnection = strategy.add_on_change_callback(this, &MainWindow::strategyStateChanged);
 
     _scene = new MainScene(strategy, this);
     _menu = new ApplicationMenu(this);
 
     setCentralWidget(_scene);
 
+    if (stg::instrumentation::is_enabled())
+        new InstrumentationHUD(this);
+
     updateWindowTitle();
 
     fsIOManager.setIsSaved(true);
@@ -160,7 +170,7 @@ void MainWindow::loadFile(const QString &path, bool inNewWindow) {
 
 void MainWindow::setStrategy(const stg::strategy &newStrategy) {
     strategy = newStrategy;
-    strategy.add_on_change_callback(this, &MainWindow::strategyStateChanged);
+    strategyConnection = strategy.add_on_change_callback(this, &MainWindow::strategyStateChanged);
 
     Application::registerOpenedFile(fsIOManager.fileInfo().filePath());
 
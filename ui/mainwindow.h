@@ -60,6 +60,7 @@ private:
     FileSystemIOManager fsIOManager = FileSystemIOManager(this);
 
     stg::strategy strategy;
+    stg::scoped_connection strategyConnection;
 
     bool alreadyTornDown = false;
 
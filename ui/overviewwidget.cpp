@@ -8,6 +8,7 @@
 
 #include "applicationsettings.h"
 #include "colorutils.h"
+#include "instrumentation.h"
 #include "overview.h"
 #include "overviewwidget.h"
 #include "slotboardscrollarea.h"
@@ -16,25 +17,61 @@
 OverviewWidget::OverviewWidget(QWidget *parent) : DataProviderWidget(parent) {
     setFixedHeight(ApplicationSettings::overviewHeight);
 
-    strategy().sessions().add_on_change_callback([this] { update(); });
+    sessionsConnection = strategy().sessions().add_on_change_callback([this] { invalidateElements(); });
 }
 
 void OverviewWidget::reloadStrategy() {
+    invalidateElements();
+}
+
+void OverviewWidget::invalidateElements() {
+    elementsPixmap = QPixmap();
     update();
 }
 
+bool OverviewWidget::elementsPixmapIsValid() const {
+    return !elementsPixmap.isNull() &&
+           elementsPixmap.devicePixelRatioF() == devicePixelRatioF() &&
+           elementsPixmap.size() == size() * devicePixelRatioF();
+}
+
+void OverviewWidget::renderElementsPixmap() {
+    auto timing = stg::instrumentation::scope("OverviewWidget::renderElementsPixmap");
+
+    elementsPixmap = QPixmap(size() * devicePixelRatioF());
+    elementsPixmap.setDevicePixelRatio(devicePixelRatioF());
+
+    auto painter = QPainter(&elementsPixmap);
+
+    painter.fillRect(0, 0, width(), height(), windowColor());
+    drawElements(painter, overview);
+}
+
 void OverviewWidget::paintEvent(QPaintEvent *) {
+    auto timing = stg::instrumentation::scope("OverviewWidget::paintEvent");
+
+    if (!elementsPixmapIsValid())
+        renderElementsPixmap();
+
     auto painter = QPainter(this);
 
-    painter.fillRect(0, 0, width(), height(), windowColor());
+    painter.drawPixmap(0, 0, elementsPixmap);
 
-    drawElements(painter, overview);
     drawViewportMarker(painter, overview);
     drawCurrentTimeMarker(painter, overview);
 
     drawBorders(painter);
 }
 
+void OverviewWidget::changeEvent(QEvent *event) {
+    if (event->type() == QEvent::PaletteChange ||
+        event->type() == QEvent::ApplicationPaletteChange) {
+        invalidateElements();
+    }
+
+    DataProviderWidget::changeEvent(event);
+}
+
 void OverviewWidget::drawBorders(QPainter &painter) {
     auto borderColor = QColor(Qt::black);
     borderColor.setAlphaF(0.1);
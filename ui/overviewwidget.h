@@ -5,6 +5,7 @@
 #ifndef STRATEGR_OVERVIEWWIDGET_H
 #define STRATEGR_OVERVIEWWIDGET_H
 
+#include <QPixmap>
 #include <QScrollArea>
 #include <QWidget>
 
@@ -22,13 +23,24 @@ public:
     void reloadStrategy();
 
 private:
+    // Background and session bands are rendered once per sessions or theme change,
+    // markers are drawn on top of the cached pixmap.
+    QPixmap elementsPixmap;
+
+    void invalidateElements();
+    bool elementsPixmapIsValid() const;
+    void renderElementsPixmap();
+
     void paintEvent(QPaintEvent *) override;
+    void changeEvent(QEvent *event) override;
     void drawElements(QPainter &painter, stg::overview &overview);
     void drawViewportMarker(QPainter &painter, stg::overview &overview);
     void drawCurrentTimeMarker(QPainter &painter, stg::overview &overview);
     void drawBorders(QPainter &painter);
 
     stg::overview overview = stg::overview(strategy(), [this] { return width(); });
+    stg::scoped_connection sessionsConnection;
+
     stg::overview::viewport_marker makeViewportMarker();
 
     void mouseMoveEvent(QMouseEvent *) override;
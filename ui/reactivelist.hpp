@@ -5,29 +5,86 @@
 #ifndef STRATEGR_REACTIVELIST_HPP
 #define STRATEGR_REACTIVELIST_HPP
 
+#include <map>
+#include <type_traits>
+#include <vector>
+
 #include <QVBoxLayout>
 
-template<class ItemWidget>
+// Items are reconciled by keys: a widget keeps showing the item with the same key,
+// so inserting, removing or moving items doesn't reconfigure the rest of the list.
+// Widgets of removed items are hidden and reused for new items later.
+// Lists that don't have stable keys are keyed by index.
+
+template<class ItemWidget, class Key = int>
 class ReactiveList {
 public:
     virtual ~ReactiveList() = default;
 
 protected:
     virtual int numberOfItems() = 0;
+
+    // Lists keyed by anything but index must override this.
+    virtual Key keyForItemAtIndex(int index) {
+        if constexpr (std::is_same_v<Key, int>) {
+            return index;
+        } else {
+            return Key();
+        }
+    }
+
     virtual QVBoxLayout *listLayout() = 0;
+
+    // Configures the widget to show an item it hasn't shown before.
     virtual void reuseItemAtIndex(int index, ItemWidget *itemWidget) = 0;
     virtual ItemWidget *makeNewItemAtIndex(int index) = 0;
 
+    // Called for the widget that keeps showing the item with the same key,
+    // possibly at a new index. Should only touch the widget if item's data has changed.
+    virtual void refreshItemAtIndex(int index, ItemWidget *itemWidget) {
+        reuseItemAtIndex(index, itemWidget);
+    }
+
     virtual void updateList() {
         if (!lastLayoutItem() || !lastLayoutItem()->spacerItem()) {
             listLayout()->addStretch();
         }
 
+        auto newKeys = std::vector<Key>();
+        newKeys.reserve(numberOfItems());
+
         for (int index = 0; index < numberOfItems(); index++) {
-            renderItemAtIndex(index);
+            newKeys.push_back(keyForItemAtIndex(index));
+        }
+
+        auto newItemWidgets = matchItemWidgets(newKeys);
+
+        for (int index = 0; index < newItemWidgets.size(); index++) {
+            auto *itemWidget = newItemWidgets[index];
+
+            if (itemWidget) {
+                refreshItemAtIndex(index, itemWidget);
+            } else if (!spareItemWidgets.empty()) {
+                itemWidget = spareItemWidgets.back();
+                spareItemWidgets.pop_back();
+
+                reuseItemAtIndex(index, itemWidget);
+            } else {
+                itemWidget = makeNewItemAtIndex(index);
+            }
+
+            placeItemWidgetAtIndex(index, itemWidget);
+            newItemWidgets[index] = itemWidget;
         }
 
-        removeExtraRows();
+        for (auto *spareItemWidget : spareItemWidgets) {
+            if (!spareItemWidget->isHidden()) {
+                spareItemWidget->hide();
+            }
+        }
+
+        itemWidgets = std::move(newItemWidgets);
+        itemKeys = std::move(newKeys);
     }
 
 protected:
@@ -36,43 +93,61 @@ protected:
     }
 
 private:
-    void renderItemAtIndex(int index) {
-        auto *currentItem = listLayout()->itemAt(index);
-        ItemWidget *itemWidget = nullptr;
+    std::vector<ItemWidget *> itemWidgets;
+    std::vector<Key> itemKeys;
+    std::vector<ItemWidget *> spareItemWidgets;
+
+    // Returns widgets for the new keys, nullptr where there's no widget with the same key.
+    // Widgets with keys that are gone are moved to the spare widgets.
+    std::vector<ItemWidget *> matchItemWidgets(const std::vector<Key> &newKeys) {
+        auto widgetsByKey = std::map<Key, ItemWidget *>();
+
+        for (int index = 0; index < itemWidgets.size(); index++) {
+            auto isUnique = widgetsByKey.emplace(itemKeys[index], itemWidgets[index]).second;
+            if (!isUnique) {
+                spareItemWidgets.push_back(itemWidgets[index]);
+            }
+        }
 
-        if (currentItem) {
-            if (currentItem->spacerItem()) {
-                itemWidget = makeNewItemAtIndex(index);
-                listLayout()->insertWidget(index, itemWidget);
+        auto result = std::vector<ItemWidget *>(newKeys.size(), nullptr);
 
-                auto spacer = listLayout()->takeAt(index + 1);
-                listLayout()->addItem(spacer);
-            } else {
-                itemWidget = dynamic_cast<ItemWidget *>(currentItem->widget());
-                reuseItemAtIndex(index, itemWidget);
+        for (int index = 0; index < newKeys.size(); index++) {
+            auto it = widgetsByKey.find(newKeys[index]);
+            if (it != widgetsByKey.end()) {
+                result[index] = it->second;
+                widgetsByKey.erase(it);
             }
         }
 
-        if (!itemWidget) {
-            itemWidget = makeNewItemAtIndex(index);
-            listLayout()->insertWidget(index, itemWidget);
+        for (auto &[key, itemWidget] : widgetsByKey) {
+            spareItemWidgets.push_back(itemWidget);
         }
 
-        if (!itemWidget->isVisible()) {
-            itemWidget->show();
-        }
+        return result;
     }
 
-    void removeExtraRows() {
-        for (auto hideAtIndex = numberOfItems();
-             hideAtIndex < listLayout()->count();
-             hideAtIndex++) {
-            auto itemToHide = listLayout()->itemAt(hideAtIndex);
-            if (itemToHide->widget() && !itemToHide->widget()->isHidden()) {
-                itemToHide->widget()->hide();
+    // Widgets before the index are already in place,
+    // so the widget is either new or somewhere after the index.
+    void placeItemWidgetAtIndex(int index, ItemWidget *itemWidget) {
+        auto *currentItem = listLayout()->itemAt(index);
+        if (currentItem && currentItem->widget() == itemWidget) {
+            if (itemWidget->isHidden()) {
+                itemWidget->show();
             }
+
+            return;
+        }
+
+        if (listLayout()->indexOf(itemWidget) >= 0) {
+            listLayout()->removeWidget(itemWidget);
         }
-    };
+
+        listLayout()->insertWidget(index, itemWidget);
+
+        if (itemWidget->isHidden()) {
+            itemWidget->show();
+        }
+    }
 
     QLayoutItem *lastLayoutItem() {
         return listLayout()->itemAt(listLayout()->count() - 1);
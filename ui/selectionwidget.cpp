@@ -11,7 +11,7 @@
 SelectionWidget::SelectionWidget(QWidget *parent) : DataProviderWidget(parent) {
     setAttribute(Qt::WA_TransparentForMouseEvents);
 
-    selection().add_on_change_callback([this] {
+    selectionConnection = selection().add_on_change_callback([this] {
         update();
     });
 }
@@ -18,6 +18,8 @@ public:
     explicit SelectionWidget(QWidget *parent);
 
 private:
+    stg::scoped_connection selectionConnection;
+
     void drawSelectionForItem(const stg::grouped_selection_element &selectionItem,
                               QPainter &painter);
 
@@ -9,6 +9,7 @@
 #include <QScrollBar>
 
 #include "currentsessionwidget.h"
+#include "instrumentation.h"
 #include "mainwindow.h"
 #include "notifierbackend.h"
 #include "overviewwidget.h"
@@ -28,7 +29,7 @@ SessionsMainWidget::SessionsMainWidget(QWidget *parent) : DataProviderWidget(par
 
     notifier.start_polling(ApplicationSettings::notifierTimerSecondsInterval);
 
-    strategy().time_slots().add_on_ruler_change_callback([this] {
+    rulerConnection = strategy().time_slots().add_on_ruler_change_callback([this] {
         strategySettingsWidget->reloadStrategy();
     });
 
@@ -107,6 +108,8 @@ void SessionsMainWidget::paintEvent(QPaintEvent *paintEvent) {
 }
 
 void SessionsMainWidget::resizeEvent(QResizeEvent *event) {
+    auto timing = stg::instrumentation::scope("SessionsMainWidget::resizeEvent");
+
     _slotBoardScrollArea->setGeometry(contentsRect());
 }
 
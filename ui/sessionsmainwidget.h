@@ -43,6 +43,8 @@ private:
     SlotBoardWidget *slotBoard = nullptr;
     OverviewWidget *overviewWidget = nullptr;
 
+    stg::scoped_connection rulerConnection;
+
     void layoutChildWidgets();
 
     void paintEvent(QPaintEvent *paintEvent) override;
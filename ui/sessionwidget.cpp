@@ -12,6 +12,7 @@
 #include "colorutils.h"
 #include "drawingutils.h"
 #include "fontutils.h"
+#include "instrumentation.h"
 #include "sessionwidget.h"
 #include "theme.h"
 
@@ -82,26 +83,54 @@ void SessionWidget::reloadSession() {
 void SessionWidget::paintEvent(QPaintEvent *) {
     QPainter painter(this);
 
+    drawSession(painter,
+                rect(),
+                session,
+                strategy().activities().get(session.activity),
+                DrawingOptions{_isSelected,
+                               _isBorderSelected,
+                               _drawsBorders,
+                               slotHeight()},
+                titleLayout);
+}
+
+void SessionWidget::drawSession(QPainter &painter,
+                                const QRect &rect,
+                                const stg::session &session,
+                                const stg::activity *activity,
+                                const DrawingOptions &options,
+                                std::optional<FontUtils::SessionTitleLayout> &titleLayout) {
+    auto timing = stg::instrumentation::scope("SessionWidget::drawSession");
+
+    painter.save();
     painter.setPen(Qt::NoPen);
 
-    if (_drawsBorders) {
-        drawBorder(painter);
+    if (options.drawsBorders) {
+        drawBorder(painter, rect, session, options);
     }
 
-    drawBackground(painter);
+    if (activity) {
+        drawBackground(painter, rect, session, *activity, options);
+    }
 
-    if (_drawsBorders) {
-        drawRulers(painter);
+    if (options.drawsBorders) {
+        drawRulers(painter, rect, session, activity, options);
     }
 
-    if (session.activity) {
-        drawLabel(painter);
+    if (activity) {
+        drawLabel(painter, rect, session, *activity, options, titleLayout);
     }
+
+    painter.restore();
 }
 
-void SessionWidget::drawRulers(QPainter &painter) {
-    QColor rulerColor = session.activity
-                            ? QColor(Application::theme().session_ruler_color(session, _isSelected))
+void SessionWidget::drawRulers(QPainter &painter,
+                               const QRect &rect,
+                               const stg::session &session,
+                               const stg::activity *activity,
+                               const DrawingOptions &options) {
+    QColor rulerColor = activity
+                            ? QColor(Application::theme().session_ruler_color(*activity, options.isSelected))
                             : borderColor();
 
     painter.setBrush(rulerColor);
@@ -114,60 +143,64 @@ void SessionWidget::drawRulers(QPainter &painter) {
         }
 
         auto thickness = timeSlot.begin_time % 60 == 0 ? 2 : 1;
-        auto rulerRect = QRect(0,
-                               slotHeight() * (timeSlotIndex),
-                               width(),
+        auto rulerRect = QRect(rect.left(),
+                               rect.top() + options.slotHeight * (timeSlotIndex),
+                               rect.width(),
                                thickness);
 
         painter.drawRect(rulerRect);
     }
 }
 
-void SessionWidget::drawBackground(QPainter &painter) {
-    if (!session.activity) {
-        return;
-    }
-
+void SessionWidget::drawBackground(QPainter &painter,
+                                   const QRect &rect,
+                                   const stg::session &session,
+                                   const stg::activity &activity,
+                                   const DrawingOptions &options) {
     QColor color = Application::theme()
-                       .session_background_color(session, _isSelected);
+                       .session_background_color(activity, options.isSelected);
 
     painter.setRenderHint(QPainter::Antialiasing);
     painter.setBrush(color);
 
-    const auto backgroundRect = QRect(0,
-                                      2 + topMargin(),
-                                      width(),
-                                      height() - 4 - topMargin());
+    const auto backgroundRect = QRect(rect.left(),
+                                      rect.top() + 2 + topMargin(session, options),
+                                      rect.width(),
+                                      rect.height() - 4 - topMargin(session, options));
     const auto radius = 5;
     const auto roundness = 0.2;
 
     painter.drawPath(DrawingUtils::squirclePath(backgroundRect, radius, roundness));
 }
 
-QColor SessionWidget::selectedBackgroundColor() const {
-    return session.activity->color();
+QColor SessionWidget::selectedBackgroundColor() {
+    return sessionColor();
 }
 
-QColor SessionWidget::sessionColor() const {
-    auto color = session.activity
-                     ? QColor(session.activity->color())
+QColor SessionWidget::sessionColor() {
+    auto *activity = strategy().activities().get(session.activity);
+    auto color = activity
+                     ? QColor(activity->color())
                      : QColor();
     return color;
 }
 
 
-void SessionWidget::drawBorder(QPainter &painter) {
+void SessionWidget::drawBorder(QPainter &painter,
+                               const QRect &rect,
+                               const stg::session &session,
+                               const DrawingOptions &options) {
     auto thickBorder = session.time_slots.front().begin_time % 60 == 0 ||
-                       _isBorderSelected;
+                       options.isBorderSelected;
 
     auto borderThickness = thickBorder ? 2 : 1;
 
-    auto borderRect = QRectF(0,
-                             0,
-                             width(),
+    auto borderRect = QRectF(rect.left(),
+                             rect.top(),
+                             rect.width(),
                              borderThickness);
 
-    painter.setBrush(_isBorderSelected ? controlColor() : borderColor());
+    painter.setBrush(options.isBorderSelected ? controlColor() : borderColor());
     painter.drawRect(borderRect);
 }
 
@@ -191,32 +224,43 @@ void SessionWidget::setIsSelected(bool isSelected) {
     update();
 }
 
-void SessionWidget::drawLabel(QPainter &painter) {
+void SessionWidget::drawLabel(QPainter &painter,
+                              const QRect &rect,
+                              const stg::session &session,
+                              const stg::activity &activity,
+                              const DrawingOptions &options,
+                              std::optional<FontUtils::SessionTitleLayout> &titleLayout) {
     using namespace ApplicationSettings;
 
-    auto font = QFont();
-    font.setBold(true);
-    font.setPixelSize(sessionFontSize);
+    static const auto font = [] {
+        auto font = QFont();
+        font.setBold(true);
+        font.setPixelSize(sessionFontSize);
+
+        return font;
+    }();
 
     painter.setFont(font);
 
-    auto textRect = QRect(defaultPadding,
-                          defaultPadding + topMargin(),
-                          width() - 2 * defaultPadding,
-                          height() - 2 * defaultPadding - topMargin());
+    auto textRect = QRect(rect.left() + defaultPadding,
+                          rect.top() + defaultPadding + topMargin(session, options),
+                          rect.width() - 2 * defaultPadding,
+                          rect.height() - 2 * defaultPadding - topMargin(session, options));
 
-    auto durationColor = Application::theme().session_duration_color(session, _isSelected);
-    auto titleColor = Application::theme().session_title_color(session, _isSelected);
+    auto durationColor = Application::theme().session_duration_color(activity, options.isSelected);
+    auto titleColor = Application::theme().session_title_color(activity, options.isSelected);
 
     FontUtils::drawSessionTitle(session,
+                                activity,
                                 painter,
                                 textRect,
+                                titleLayout,
                                 durationColor,
                                 titleColor);
 
     painter.setPen(Qt::NoPen);
 }
 
-int SessionWidget::topMargin() {
-    return session.time_slots.front().begin_time % 60 == 0 || _isBorderSelected ? 2 : 1;
+int SessionWidget::topMargin(const stg::session &session, const DrawingOptions &options) {
+    return session.time_slots.front().begin_time % 60 == 0 || options.isBorderSelected ? 2 : 1;
 }
@@ -4,15 +4,39 @@
 #include "applicationsettings.h"
 #include "colorprovider.h"
 #include "dataproviderwidget.h"
+#include "fontutils.h"
 #include "session.h"
 #include "strategy.h"
 
+#include <optional>
+
 #include <QMap>
+#include <QPainter>
 #include <QWidget>
 
 class SessionWidget : public DataProviderWidget, public ColorProvider {
 public:
+    struct DrawingOptions {
+        bool isSelected = false;
+        bool isBorderSelected = false;
+        bool drawsBorders = true;
+        int slotHeight = ApplicationSettings::defaultSlotHeight;
+    };
+
     static QColor borderColor();
+
+    // Draws the session into the rect of the painter's device,
+    // so that sessions can be painted without a widget of their own.
+    // The title layout is kept by the caller between repaints of the session.
+    // The activity is resolved from the session's handle by the caller,
+    // and is null if the session is empty or its activity is gone.
+    static void drawSession(QPainter &painter,
+                            const QRect &rect,
+                            const stg::session &session,
+                            const stg::activity *activity,
+                            const DrawingOptions &options,
+                            std::optional<FontUtils::SessionTitleLayout> &titleLayout);
+
     explicit SessionWidget(const stg::session &session, QWidget *parent);
 
     void setIsSelected(bool isSelected);
@@ -28,22 +52,41 @@ private:
     stg::session session;
     stg::session previousSession = stg::session();
 
+    std::optional<FontUtils::SessionTitleLayout> titleLayout;
+
     stg::strategy::duration_t previousDuration = 0;
     stg::strategy::time_t previousEndTime = 0;
 
     void reloadSession();
     int expectedHeight();
-    int topMargin();
 
-    QColor selectedBackgroundColor() const;
-    QColor sessionColor() const;
+    QColor selectedBackgroundColor();
+    QColor sessionColor();
 
     void paintEvent(QPaintEvent *event) override;
 
-    void drawBorder(QPainter &painter);
-    void drawBackground(QPainter &painter);
-    void drawRulers(QPainter &painter);
-    void drawLabel(QPainter &painter);
+    static int topMargin(const stg::session &session, const DrawingOptions &options);
+
+    static void drawBorder(QPainter &painter,
+                           const QRect &rect,
+                           const stg::session &session,
+                           const DrawingOptions &options);
+    static void drawBackground(QPainter &painter,
+                               const QRect &rect,
+                               const stg::session &session,
+                               const stg::activity &activity,
+                               const DrawingOptions &options);
+    static void drawRulers(QPainter &painter,
+                           const QRect &rect,
+                           const stg::session &session,
+                           const stg::activity *activity,
+                           const DrawingOptions &options);
+    static void drawLabel(QPainter &painter,
+                          const QRect &rect,
+                          const stg::session &session,
+                          const stg::activity &activity,
+                          const DrawingOptions &options,
+                          std::optional<FontUtils::SessionTitleLayout> &titleLayout);
 };
 
 
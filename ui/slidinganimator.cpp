@@ -138,6 +138,11 @@ void SlidingAnimator::showFrame(qreal value) {
 
 void SlidingAnimator::showFinished() {
     setWidgetSize(initialWidgetSize);
+
+    if (animatesSnapshot) {
+        widget->show();
+    }
+
     teardown();
 }
 
@@ -199,6 +204,12 @@ void SlidingAnimator::updateWidgetGeometryOnStubResize() {
         return;
     }
 
+    if (animatesSnapshot) {
+        auto translation = widgetRelativeCoordinate();
+        stub->setSnapshotOffset(makePointByTranslation(QPoint(), translation));
+        return;
+    }
+
     auto geometry = widget->geometry();
     auto translation = widgetRelativeCoordinate();
     auto origin = makePointByTranslation(geometry.topLeft(), translation);
@@ -218,20 +229,49 @@ void SlidingAnimator::prepareOperation() {
     createStub();
     commitWidget();
 
-    if (operation == Operation::Show) {
+    if (animatesSnapshot) {
+        // Real widget stays hidden until the animation is finished.
+        takeSnapshot();
+        widget->hide();
+        updateWidgetGeometryOnStubResize();
+    } else if (operation == Operation::Show) {
         widget->show();
     }
 
     timeLine = makeTimeLine();
 }
 
+QSize SlidingAnimator::snapshotSize() {
+    auto parentRect = widgetParentLayout()->contentsRect();
+    return applyInitialSizeToRect(parentRect, initialWidgetSize);
+}
+
+void SlidingAnimator::takeSnapshot() {
+    auto size = snapshotSize();
+    if (size.isEmpty())
+        return;
+
+    widget->resize(size);
+
+    auto devicePixelRatio = widget->devicePixelRatioF();
+    auto snapshot = QPixmap(size * devicePixelRatio);
+    snapshot.setDevicePixelRatio(devicePixelRatio);
+    snapshot.fill(Qt::transparent);
+
+    // Hidden widgets are laid out before rendering.
+    widget->render(&snapshot);
+
+    stub->setSnapshot(snapshot);
+}
+
 SlidingAnimator::SlidingAnimator(QWidget *widget, const Options &options)
     : QObject(widget),
       widget(widget),
       direction(options.direction),
       duration(options.duration),
       updateInterval(options.updateInterval),
-      curveShape(options.curveShape) {}
+      curveShape(options.curveShape),
+      animatesSnapshot(options.animatesSnapshot) {}
 
 void SlidingAnimator::show() {
     if (widgetIsInOperation() || !widget->isHidden()) {
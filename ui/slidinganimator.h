@@ -2,6 +2,8 @@
 #define SLIDINGANIMATOR_H
 
 #include <QLayout>
+#include <QPainter>
+#include <QPixmap>
 #include <QTimeLine>
 #include <QWidget>
 
@@ -29,6 +31,11 @@ public:
         QTimeLine::CurveShape curveShape = defaultCurveShape;
         std::function<void()> onFinishedCallback = nullptr;
 
+        // If set, the widget is rendered into a pixmap once,
+        // and the pixmap is animated instead of the live widget,
+        // so frames don't relayout and repaint the widget's subtree.
+        bool animatesSnapshot = false;
+
         // Explicit constructor definition is needed here because of clang bug.
         // See: https://stackoverflow.com/questions/53408962
         Options(){};
@@ -64,6 +71,7 @@ private:
     int duration;
     int updateInterval;
     QTimeLine::CurveShape curveShape;
+    bool animatesSnapshot;
 
     Operation operation;
 
@@ -132,6 +140,9 @@ private:
     void updateWidgetGeometryOnStubResize();
     void prepareOperation();
 
+    QSize snapshotSize();
+    void takeSnapshot();
+
     void hide();
     void show();
 
@@ -149,14 +160,38 @@ class SlidingAnimator::ResizeAwareWidget : public QWidget {
 public:
     explicit ResizeAwareWidget(QWidget *parent = nullptr) : QWidget(parent) {}
 
+    void setSnapshot(const QPixmap &newSnapshot) {
+        snapshot = newSnapshot;
+        update();
+    }
+
+    void setSnapshotOffset(const QPoint &offset) {
+        if (offset == snapshotOffset)
+            return;
+
+        snapshotOffset = offset;
+        update();
+    }
+
 signals:
     void resized();
 
 private:
+    QPixmap snapshot;
+    QPoint snapshotOffset;
+
     void resizeEvent(QResizeEvent *event) override {
         QWidget::resizeEvent(event);
         emit resized();
     }
+
+    void paintEvent(QPaintEvent *) override {
+        if (snapshot.isNull())
+            return;
+
+        auto painter = QPainter(this);
+        painter.drawPixmap(snapshotOffset, snapshot);
+    }
 };
 
 #endif// SLIDINGANIMATOR_H
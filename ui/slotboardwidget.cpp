@@ -7,6 +7,7 @@
 #include <QTimer>
 
 #include "currenttimemarker.h"
+#include "instrumentation.h"
 #include "mainwindow.h"
 #include "slotboardscrollarea.h"
 #include "slotboardwidget.h"
@@ -52,7 +53,7 @@ SlotBoardWidget::SlotBoardWidget(QWidget *parent) : DataProviderWidget(parent) {
     auto child_on_resize_boundary_change = mouseHandler().on_resize_boundary_change;
     mouseHandler().on_resize_boundary_change = [this, child_on_resize_boundary_change]() {
         child_on_resize_boundary_change();
-        slotRuler->reloadStrategy();
+        slotRuler->updateHighlights();
 
         update();
     };
@@ -120,6 +121,8 @@ void SlotBoardWidget::drawResizeBoundaryCircles(QPainter &painter) {
 }
 
 void SlotBoardWidget::resizeEvent(QResizeEvent *event) {
+    auto timing = stg::instrumentation::scope("SlotBoardWidget::resizeEvent");
+
     updateCurrentTimeMarker();
 }
 
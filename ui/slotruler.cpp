@@ -1,19 +1,21 @@
-#include <QDebug>
+#include <algorithm>
+
+#include <QPaintEvent>
 #include <QPainter>
-#include <QStyleOption>
-#include <QVBoxLayout>
 
 #include "applicationsettings.h"
+#include "instrumentation.h"
 #include "slotboardwidget.h"
 #include "slotruler.h"
 #include "slotswidget.h"
 #include "utils.h"
 
 SlotRuler::SlotRuler(QWidget *parent) : DataProviderWidget(parent) {
-    auto *layout = new QVBoxLayout();
-    layout->setContentsMargins(0, 0, 0, 0);
-    layout->setSpacing(0);
-    setLayout(layout);
+    bigFont.setPixelSize(bigFontHeight);
+    bigFont.setBold(true);
+
+    smallFont.setPixelSize(smallFontHeight);
+    smallFont.setBold(true);
 
     auto fontWidth = calculateLabelWidth() + 2 * ApplicationSettings::defaultPadding;
     auto width = std::max(fontWidth, 40);
@@ -21,116 +23,143 @@ SlotRuler::SlotRuler(QWidget *parent) : DataProviderWidget(parent) {
 
     reloadStrategy();
 
-    selection().add_on_change_callback(this, &SlotRuler::reloadStrategy);
-    strategy().time_slots().add_on_ruler_change_callback([this] {
+    selectionConnection = selection().add_on_change_callback(this, &SlotRuler::updateHighlights);
+    rulerConnection = strategy().time_slots().add_on_ruler_change_callback([this] {
         reloadStrategy();
     });
 }
 
 int SlotRuler::calculateLabelWidth() {
-    auto font = QFont();
-    font.setPixelSize(bigFontHeight);
-    font.setBold(true);
-
-    return QFontMetrics(font)
+    return QFontMetrics(bigFont)
         .horizontalAdvance(QStringForMinutes(0));
 }
 
-void SlotRuler::paintEvent(QPaintEvent *) {
-    //    QPainter p(this);
-    //
-    //    auto handleBorderColor = highlightColor();
-    //    handleBorderColor.setAlphaF(0.25);
-    //
-    //    auto handleBgColor = highlightColor();
-    //    handleBgColor.setAlphaF(0.1);
-    //
-    //    p.setBrush(handleBgColor);
-    //    p.setPen(handleBorderColor);
-
-    //    for (auto &selectionSegment : selection().grouped()) {
-    //        auto firstIndex = selectionSegment.front();
-    //        auto lastIndex = selectionSegment.back() + 1;
-    //
-    //        auto handleWidth = calculateLabelWidth() + 4;
-    //        auto handleHeight = bigFontHeight * 1.5;
-    //
-    //        auto rect1 = QRect((width() - handleWidth) / 2,
-    //                           firstIndex * cellHeight() + (cellHeight() - handleHeight) / 2,
-    //                           handleWidth,
-    //                           handleHeight);
-    //
-    //        auto rect2 = QRect((width() - handleWidth) / 2,
-    //                           lastIndex * cellHeight() + (cellHeight() - handleHeight) / 2,
-    //                           handleWidth,
-    //                           handleHeight);
-    //
-    //
-    //        p.drawRoundedRect(rect1, 2, 2);
-    //        p.drawRoundedRect(rect2, 2, 2);
-    //    }
-}
+void SlotRuler::reloadStrategy() {
+    auto timing = stg::instrumentation::scope("SlotRuler::reloadStrategy");
 
-int SlotRuler::numberOfItems() {
-    return strategy().time_slots().ruler_times().size();
-}
+    reloadLabels();
+    highlightedIndices = makeHighlightedIndices();
 
-QVBoxLayout *SlotRuler::listLayout() {
-    return dynamic_cast<QVBoxLayout *>(layout());
+    update();
 }
 
-void SlotRuler::reuseItemAtIndex(int index, ColoredLabel *itemWidget) {
-    if (slotTimeChangedAt(index)) {
-        itemWidget->setText(labelAtIndex(index));
+void SlotRuler::reloadLabels() {
+    const auto &rulerTimes = strategy().time_slots().ruler_times();
+
+    auto newLabels = std::vector<Label>();
+    newLabels.reserve(rulerTimes.size());
+
+    for (auto time : rulerTimes) {
+        auto isIntegerHour = time % 3600 == 0;
+
+        auto text = QStaticText(QStringForCalendarTime(time));
+        text.setTextFormat(Qt::PlainText);
+        text.setPerformanceHint(QStaticText::AggressiveCaching);
+        text.prepare(QTransform(), isIntegerHour ? bigFont : smallFont);
+
+        newLabels.push_back(Label{time, text, isIntegerHour});
     }
 
-    itemWidget->setFixedHeight(slotHeight());
-    itemWidget->setFontHeight(isIntegerHourAtIndex(index) ? bigFontHeight : smallFontHeight);
-    itemWidget->setDynamicColor(labelColorGetterAtIndex(index));
+    labels = std::move(newLabels);
+
+    setMinimumHeight(static_cast<int>(labels.size()) * slotHeight());
 }
 
-SlotRuler::ColorGetter SlotRuler::labelColorGetterAtIndex(int index) {
-    auto colorGetter = this->isIntegerHourAtIndex(index)
-                           ? &SlotRuler::secondaryTextColor
-                           : &SlotRuler::tertiaryTextColor;
+void SlotRuler::updateHighlights() {
+    auto newHighlightedIndices = makeHighlightedIndices();
+    if (newHighlightedIndices == highlightedIndices)
+        return;
 
-    if (selection().is_boundary(index) || mouseHandler().resize_boundary().slot_index == index - 1) {
-        colorGetter = &SlotRuler::controlColor;
-    }
+    auto changedIndices = std::vector<int>();
+    std::set_symmetric_difference(highlightedIndices.begin(),
+                                  highlightedIndices.end(),
+                                  newHighlightedIndices.begin(),
+                                  newHighlightedIndices.end(),
+                                  std::back_inserter(changedIndices));
 
-    return colorGetter;
+    highlightedIndices = std::move(newHighlightedIndices);
+
+    for (auto index : changedIndices) {
+        update(labelRectAtIndex(index));
+    }
 }
 
-ColoredLabel *SlotRuler::makeNewItemAtIndex(int index) {
-    auto label = new ColoredLabel();
-    label->setAlignment(Qt::AlignCenter);
-    label->setFixedHeight(slotHeight());
-    label->setBold(true);
-    label->setFontHeight(isIntegerHourAtIndex(index) ? bigFontHeight : smallFontHeight);
-    label->setDynamicColor(labelColorGetterAtIndex(index));
-    label->setText(labelAtIndex(index));
+std::vector<int> SlotRuler::makeHighlightedIndices() {
+    auto result = std::vector<int>();
+
+    for (const auto &selectionItem : selection().grouped()) {
+        result.push_back(selectionItem.front());
+        result.push_back(selectionItem.back() + 1);
+    }
+
+    auto resizeBoundaryIndex = mouseHandler().resize_boundary().slot_index + 1;
+    if (resizeBoundaryIndex >= 0)
+        result.push_back(resizeBoundaryIndex);
 
-    return label;
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+
+    return result;
 }
 
-bool SlotRuler::isIntegerHourAtIndex(int index) {
-    auto time = strategy().time_slots().ruler_times()[index];
-    return time % 3600 == 0;
+bool SlotRuler::isHighlightedAtIndex(int index) const {
+    return std::binary_search(highlightedIndices.begin(),
+                              highlightedIndices.end(),
+                              index);
 }
 
-bool SlotRuler::slotTimeChangedAt(int index) {
-    auto indexIsSafe = index < prevTimes.size() && index >= 0;
-    auto &slotTime = strategy().time_slots().ruler_times()[index];
+SlotRuler::ColorGetter SlotRuler::labelColorGetterAtIndex(int index) const {
+    if (isHighlightedAtIndex(index))
+        return &SlotRuler::controlColor;
 
-    return indexIsSafe && prevTimes[index] != slotTime;
+    return labels[index].isIntegerHour
+               ? &SlotRuler::secondaryTextColor
+               : &SlotRuler::tertiaryTextColor;
 }
 
-QString SlotRuler::labelAtIndex(int index) {
-    auto time = strategy().time_slots().ruler_times()[index];
-    return QStringForCalendarTime(time);
+QRect SlotRuler::labelRectAtIndex(int index) {
+    return QRect(0, index * slotHeight(), width(), slotHeight());
 }
 
-void SlotRuler::reloadStrategy() {
-    updateList();
-    prevTimes = strategy().time_slots().ruler_times();
+void SlotRuler::paintEvent(QPaintEvent *event) {
+    auto timing = stg::instrumentation::scope("SlotRuler::paintEvent");
+
+    if (labels.empty())
+        return;
+
+    auto painter = QPainter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    auto lastIndex = static_cast<int>(labels.size()) - 1;
+    auto firstVisibleIndex = std::clamp(event->rect().top() / slotHeight(), 0, lastIndex);
+    auto lastVisibleIndex = std::clamp(event->rect().bottom() / slotHeight(), 0, lastIndex);
+
+    for (auto index = firstVisibleIndex; index <= lastVisibleIndex; index++) {
+        const auto &label = labels[index];
+
+        auto rect = labelRectAtIndex(index);
+        auto textSize = label.text.size();
+        auto origin = QPointF(rect.left() + (rect.width() - textSize.width()) / 2,
+                              rect.top() + (rect.height() - textSize.height()) / 2);
+
+        painter.setFont(label.isIntegerHour ? bigFont : smallFont);
+        painter.setPen(labelColorGetterAtIndex(index)());
+        painter.drawStaticText(origin, label.text);
+    }
+}
+
+void SlotRuler::changeEvent(QEvent *event) {
+    // Labels depend on locale's time format and on the font,
+    // colors are fetched when painting.
+    if (event->type() == QEvent::LocaleChange ||
+        event->type() == QEvent::FontChange ||
+        event->type() == QEvent::ApplicationFontChange) {
+        reloadLabels();
+        update();
+    } else if (event->type() == QEvent::PaletteChange ||
+               event->type() == QEvent::ApplicationPaletteChange) {
+        update();
+    }
+
+    DataProviderWidget::changeEvent(event);
 }
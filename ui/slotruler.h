@@ -1,45 +1,61 @@
 #ifndef SLOTRULER_H
 #define SLOTRULER_H
 
+#include <ctime>
+#include <vector>
+
+#include <QStaticText>
 #include <QStringList>
 #include <QWidget>
 
 #include "applicationsettings.h"
-#include "coloredlabel.h"
 #include "colorprovider.h"
 #include "dataproviderwidget.h"
-#include "reactivelist.hpp"
 
 class SlotsWidget;
+
+// Time labels are laid out once per ruler change and painted from cache,
+// selection changes only repaint labels whose highlight has changed.
 class SlotRuler : public DataProviderWidget,
-                  public ReactiveList<ColoredLabel>,
                   public ColorProvider {
     Q_OBJECT
 public:
     explicit SlotRuler(QWidget *parent = nullptr);
 
     void reloadStrategy();
+    void updateHighlights();
 
 private:
     using ColorGetter = QColor (*)();
 
-    std::vector<std::time_t> prevTimes;
+    struct Label {
+        std::time_t time = 0;
+        QStaticText text;
+        bool isIntegerHour = false;
+    };
 
-    int calculateLabelWidth();
-    bool isIntegerHourAtIndex(int index);
-    bool slotTimeChangedAt(int index);
+    std::vector<Label> labels;
+
+    // Sorted indices of labels at selection or resize boundaries.
+    std::vector<int> highlightedIndices;
 
-    ColorGetter labelColorGetterAtIndex(int index);
+    QFont bigFont;
+    QFont smallFont;
+
+    stg::scoped_connection selectionConnection;
+    stg::scoped_connection rulerConnection;
+
+    int calculateLabelWidth();
 
-    QString labelAtIndex(int index);
+    void reloadLabels();
+    std::vector<int> makeHighlightedIndices();
+    bool isHighlightedAtIndex(int index) const;
 
-    // ReactiveList
-    int numberOfItems() override;
-    QVBoxLayout *listLayout() override;
-    void reuseItemAtIndex(int index, ColoredLabel *itemWidget) override;
-    ColoredLabel *makeNewItemAtIndex(int index) override;
+    ColorGetter labelColorGetterAtIndex(int index) const;
+    QRect labelRectAtIndex(int index);
 
-    void paintEvent(QPaintEvent *) override;
+    void paintEvent(QPaintEvent *event) override;
+    void changeEvent(QEvent *event) override;
 
     static const int bigFontHeight = 10;
     static const int smallFontHeight = 9;
@@ -1,10 +1,14 @@
+#include <algorithm>
+
 #include <QLayout>
 #include <QMenu>
+#include <QPaintEvent>
 #include <QPainter>
 #include <QScrollBar>
 #include <QStyleOption>
 #include <QVector>
 
+#include "instrumentation.h"
 #include "mainscene.h"
 #include "mainwindow.h"
 #include "slotswidget.h"
@@ -13,7 +17,8 @@
 SlotsWidget::SlotsWidget(QWidget *parent) : DataProviderWidget(parent) {
     setMouseTracking(true);
 
-    strategy().sessions().add_on_change_callback([this] { reloadStrategy(); });
+    sessionsConnection = strategy().sessions().add_on_change_callback([this] { reloadStrategy(); });
+    dragPreviewConnection = strategy().drag_preview().add_on_change_callback([this] { reloadSessionItems(); });
 
     setContentsMargins(0, 0, ApplicationSettings::defaultPadding, 0);
 
@@ -21,32 +26,16 @@ SlotsWidget::SlotsWidget(QWidget *parent) : DataProviderWidget(parent) {
     setupActions();
     reloadStrategy();
 
-    mouseHandler().on_select_sessions = [this](const auto &sessionIndices) {
-        for (auto sessionIndex = 0; sessionIndex < strategy().sessions().size(); sessionIndex++) {
-            auto *sessionWidget = dynamic_cast<SessionWidget *>(slotsLayout->itemAt(sessionIndex)->widget());
+    // High polling rate mice send many more moves than can be drawn.
+    mouseHandler().settings.coalesces_mouse_moves = true;
 
-            if (!sessionWidget)
-                continue;
-
-            auto isSelected = std::find(sessionIndices.begin(),
-                                        sessionIndices.end(),
-                                        sessionIndex) != sessionIndices.end();
-            sessionWidget->setIsSelected(isSelected);
-            sessionWidget->setIsBorderSelected(false);
-        }
+    mouseHandler().on_select_sessions = [this](const auto &sessionIndices) {
+        selectSessions(sessionIndices);
     };
 
     mouseHandler().on_resize_boundary_change = [this]() {
         auto boundarySessionIndex = mouseHandler().resize_boundary().session_index;
-        for (auto sessionIndex = 0; sessionIndex < strategy().sessions().size(); sessionIndex++) {
-            auto *sessionWidget = dynamic_cast<SessionWidget *>(slotsLayout->itemAt(sessionIndex)->widget());
-
-            if (!sessionWidget)
-                continue;
-
-            auto isBorderSelected = boundarySessionIndex + 1 == sessionIndex;
-            sessionWidget->setIsBorderSelected(isBorderSelected);
-        }
+        selectBorderBeforeSession(boundarySessionIndex + 1);
 
         update();
     };
@@ -72,7 +61,7 @@ SlotsWidget::SlotsWidget(QWidget *parent) : DataProviderWidget(parent) {
     };
 
     mouseHandler().on_auto_scroll_frame = [this](stg::gfloat offsetIncrement) {
-        auto newOffset = slotboardScrollArea()->verticalScrollBar()->value() + (int) offsetIncrement;
+        auto newOffset = slotboardScrollArea()->verticalScrollBar()->value() + qRound(offsetIncrement);
         slotboardScrollArea()->setScrollOffset(newOffset);
 
         return mapFromGlobal(QCursor::pos());
@@ -95,15 +84,6 @@ SlotsWidget::SlotsWidget(QWidget *parent) : DataProviderWidget(parent) {
 }
 
 void SlotsWidget::layoutChildWidgets() {
-    slotsLayout = new QVBoxLayout();
-    slotsLayout->setSpacing(0);
-    updateSlotsLayoutContentMargins();
-
-    slotsWidget = new QWidget(this);
-    slotsWidget->setAttribute(Qt::WA_TransparentForMouseEvents);
-    slotsWidget->setContentsMargins(0, 0, 0, 0);
-    slotsWidget->setLayout(slotsLayout);
-
     selectionWidget = new SelectionWidget(this);
 }
 
@@ -142,29 +122,150 @@ void SlotsWidget::setupActions() {
 }
 
 void SlotsWidget::reloadStrategy() {
-    updateSlotsLayoutContentMargins();
-    updateList();
+    reloadSessionItems();
 }
 
-int SlotsWidget::numberOfItems() {
-    return strategy().sessions().size();
+const stg::sessions_list &SlotsWidget::displayedSessions() {
+    return strategy().is_dragging()
+               ? strategy().drag_preview()
+               : strategy().sessions();
 }
 
-QVBoxLayout *SlotsWidget::listLayout() {
-    return slotsLayout;
+void SlotsWidget::reloadSessionItems() {
+    auto timing = stg::instrumentation::scope("SlotsWidget::reloadSessionItems");
+
+    const auto &sessions = displayedSessions();
+    auto boundarySessionIndex = mouseHandler().resize_boundary().session_index;
+
+    auto newSessionItems = std::vector<SessionItem>();
+    newSessionItems.reserve(sessions.size());
+
+    auto top = slotHeight() / 2;
+    for (const auto &session : sessions) {
+        auto sessionIndex = static_cast<int>(newSessionItems.size());
+        auto height = session.length() * slotHeight();
+
+        auto *activity = strategy().activities().get(session.activity);
+        auto activityHash = activity
+                                ? activity->content_hash()
+                                : stg::content_hash_t(0);
+
+        newSessionItems.push_back(SessionItem{session,
+                                              top,
+                                              height,
+                                              false,
+                                              boundarySessionIndex + 1 == sessionIndex,
+                                              activityHash});
+        top += height;
+    }
+
+    // Only repaint sessions that have actually changed.
+    auto dirtyRegion = QRegion();
+    auto commonCount = std::min(sessionItems.size(), newSessionItems.size());
+
+    for (size_t index = 0; index < commonCount; index++) {
+        auto &item = sessionItems[index];
+        auto &newItem = newSessionItems[index];
+
+        // The layout is checked against the session when painted.
+        newItem.titleLayout = std::move(item.titleLayout);
+
+        if (item.session != newItem.session ||
+            item.activityHash != newItem.activityHash ||
+            item.top != newItem.top ||
+            item.height != newItem.height ||
+            item.isSelected != newItem.isSelected ||
+            item.isBorderSelected != newItem.isBorderSelected) {
+            dirtyRegion += rectForSessionItem(item);
+            dirtyRegion += rectForSessionItem(newItem);
+        }
+    }
+
+    for (auto index = commonCount; index < sessionItems.size(); index++)
+        dirtyRegion += rectForSessionItem(sessionItems[index]);
+
+    for (auto index = commonCount; index < newSessionItems.size(); index++)
+        dirtyRegion += rectForSessionItem(newSessionItems[index]);
+
+    sessionItems = std::move(newSessionItems);
+    selectedSessionIndices.clear();
+    borderSelectedSessionIndex = boundarySessionIndex + 1;
+
+    if (!dirtyRegion.isEmpty())
+        update(dirtyRegion);
 }
 
-void SlotsWidget::reuseItemAtIndex(int index, SessionWidget *itemWidget) {
-    const auto session = strategy().sessions()[index];
-    itemWidget->setSession(session);
-    itemWidget->setIsBorderSelected(mouseHandler().resize_boundary().session_index + 1 == index);
-    itemWidget->setIsSelected(false);
+void SlotsWidget::selectSessions(const std::vector<int> &sessionIndices) {
+    for (auto sessionIndex : selectedSessionIndices) {
+        if (!hasSessionItem(sessionIndex))
+            continue;
+
+        sessionItems[sessionIndex].isSelected = false;
+        updateSessionItem(sessionIndex);
+    }
+
+    selectedSessionIndices.clear();
+
+    for (auto sessionIndex : sessionIndices) {
+        if (!hasSessionItem(sessionIndex))
+            continue;
+
+        sessionItems[sessionIndex].isSelected = true;
+        selectedSessionIndices.push_back(sessionIndex);
+        updateSessionItem(sessionIndex);
+    }
+
+    selectBorderBeforeSession(-1);
+}
+
+void SlotsWidget::selectBorderBeforeSession(int sessionIndex) {
+    if (sessionIndex == borderSelectedSessionIndex)
+        return;
+
+    if (hasSessionItem(borderSelectedSessionIndex)) {
+        sessionItems[borderSelectedSessionIndex].isBorderSelected = false;
+        updateSessionItem(borderSelectedSessionIndex);
+    }
+
+    borderSelectedSessionIndex = sessionIndex;
+
+    if (hasSessionItem(sessionIndex)) {
+        sessionItems[sessionIndex].isBorderSelected = true;
+        updateSessionItem(sessionIndex);
+    }
 }
 
-SessionWidget *SlotsWidget::makeNewItemAtIndex(int index) {
-    const auto session = strategy().sessions()[index];
-    auto *itemWidget = new SessionWidget(session, this);
-    return itemWidget;
+bool SlotsWidget::hasSessionItem(int sessionIndex) const {
+    return sessionIndex >= 0 && sessionIndex < static_cast<int>(sessionItems.size());
+}
+
+int SlotsWidget::sessionsWidth() {
+    return contentsRect().width();
+}
+
+QRect SlotsWidget::rectForSessionItem(const SessionItem &item) {
+    return QRect(contentsRect().left(), item.top, sessionsWidth(), item.height);
+}
+
+void SlotsWidget::updateSessionItem(int sessionIndex) {
+    update(rectForSessionItem(sessionItems[sessionIndex]));
+}
+
+std::pair<int, int> SlotsWidget::sessionItemsRangeInRect(const QRect &rect) {
+    auto first = std::partition_point(sessionItems.begin(),
+                                      sessionItems.end(),
+                                      [&rect](const SessionItem &item) {
+                                          return item.bottom() <= rect.top();
+                                      });
+
+    auto last = std::partition_point(first,
+                                     sessionItems.end(),
+                                     [&rect](const SessionItem &item) {
+                                         return item.top <= rect.bottom();
+                                     });
+
+    return {static_cast<int>(first - sessionItems.begin()),
+            static_cast<int>(last - sessionItems.begin())};
 }
 
 void SlotsWidget::mouseMoveEvent(QMouseEvent *event) {
@@ -188,9 +289,26 @@ void SlotsWidget::keyReleaseEvent(QKeyEvent *event) {
 }
 
 void SlotsWidget::paintEvent(QPaintEvent *event) {
+    auto timing = stg::instrumentation::scope("SlotsWidget::paintEvent");
+
     using namespace ApplicationSettings;
     QPainter painter(this);
 
+    auto [firstIndex, lastIndex] = sessionItemsRangeInRect(event->rect());
+    for (auto sessionIndex = firstIndex; sessionIndex < lastIndex; sessionIndex++) {
+        auto &item = sessionItems[sessionIndex];
+
+        SessionWidget::drawSession(painter,
+                                   rectForSessionItem(item),
+                                   item.session,
+                                   strategy().activities().get(item.session.activity),
+                                   SessionWidget::DrawingOptions{item.isSelected,
+                                                                 item.isBorderSelected,
+                                                                 true,
+                                                                 slotHeight()},
+                                   item.titleLayout);
+    }
+
     auto isResizeBoundary = mouseHandler().resize_boundary().slot_index == strategy().number_of_time_slots() - 1;
     auto borderColor = isResizeBoundary ? controlColor() : ColorProvider::borderColor();
     auto thickness = isResizeBoundary ? 2 : topLineThickness();
@@ -210,12 +328,7 @@ int SlotsWidget::topLineThickness() {
     return strategy().end_time() % 60 == 0 ? 2 : 1;
 }
 
-void SlotsWidget::updateSlotsLayoutContentMargins() {
-    slotsLayout->setContentsMargins(0, slotHeight() / 2, 0, 0);
-}
-
 void SlotsWidget::resizeEvent(QResizeEvent *event) {
-    slotsWidget->setGeometry(contentsRect());
     selectionWidget->setGeometry(contentsRect());
 }
 
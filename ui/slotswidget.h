@@ -12,14 +12,15 @@
 #include "colorprovider.h"
 #include "cursorprovider.h"
 #include "dataproviderwidget.h"
-#include "reactivelist.hpp"
 #include "selection.h"
 #include "selectionwidget.h"
 #include "sessionwidget.h"
 #include "slotruler.h"
 
+// Sessions are painted directly into this widget, and only the ones
+// intersecting the exposed rect are drawn, so scrolling and selection
+// don't depend on the number of sessions in the strategy.
 class SlotsWidget : public DataProviderWidget,
-                    public ReactiveList<SessionWidget>,
                     private CursorProvider,
                     private ColorProvider {
     Q_OBJECT
@@ -35,21 +36,53 @@ public:
     void reloadStrategy();
 
 private:
-    QVBoxLayout *slotsLayout = nullptr;
-    QWidget *slotsWidget = nullptr;
+    // Render data is cached per session, so painting doesn't touch the model.
+    struct SessionItem {
+        stg::session session;
+        int top = 0;
+        int height = 0;
+        bool isSelected = false;
+        bool isBorderSelected = false;
+
+        // Activities are edited in place, so sessions stay equal when their activity is renamed.
+        stg::content_hash_t activityHash = 0;
+
+        std::optional<FontUtils::SessionTitleLayout> titleLayout = std::nullopt;
+
+        int bottom() const {
+            return top + height;
+        }
+    };
+
     SelectionWidget *selectionWidget = nullptr;
 
+    std::vector<SessionItem> sessionItems;
+    std::vector<int> selectedSessionIndices;
+    int borderSelectedSessionIndex = -1;
+
+    stg::scoped_connection sessionsConnection;
+    stg::scoped_connection dragPreviewConnection;
+
     void setupActions();
     void layoutChildWidgets();
 
     int topLineThickness();
-    void updateSlotsLayoutContentMargins();
+    int sessionsWidth();
+
+    // While a session is being dragged, its proposed layout is shown
+    // instead of the model's sessions.
+    const stg::sessions_list &displayedSessions();
+
+    void reloadSessionItems();
+    void selectSessions(const std::vector<int> &sessionIndices);
+    void selectBorderBeforeSession(int sessionIndex);
+
+    bool hasSessionItem(int sessionIndex) const;
+    QRect rectForSessionItem(const SessionItem &item);
+    void updateSessionItem(int sessionIndex);
 
-    // ReactiveList
-    int numberOfItems() override;
-    QVBoxLayout *listLayout() override;
-    void reuseItemAtIndex(int index, SessionWidget *itemWidget) override;
-    SessionWidget *makeNewItemAtIndex(int index) override;
+    // Returns the half-open range of cached sessions intersecting the rect.
+    std::pair<int, int> sessionItemsRangeInRect(const QRect &rect);
 
     void mousePressEvent(QMouseEvent *event) override;
     void mouseMoveEvent(QMouseEvent *event) override;
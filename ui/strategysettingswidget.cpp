@@ -205,12 +205,14 @@ void StrategySettingsWidget::updateUI() {
 void StrategySettingsWidget::slideAndHide(const std::function<void()> &onFinishedCallback) {
     SlidingAnimator::Options options;
     options.onFinishedCallback = onFinishedCallback;
+    options.animatesSnapshot = true;
     SlidingAnimator::hideWidget(this, options);
 }
 
 void StrategySettingsWidget::slideAndShow(const std::function<void()> &onFinishedCallback) {
     SlidingAnimator::Options options;
     options.onFinishedCallback = onFinishedCallback;
+    options.animatesSnapshot = true;
     SlidingAnimator::showWidget(this, options);
 }
 
@@ -5,9 +5,12 @@
 #ifndef STRATEGR_BACKENDS_H
 #define STRATEGR_BACKENDS_H
 
+#include <QCoreApplication>
 #include <QTimer>
 #include <utility>
 
+#include "notifiableonchange.h"
+#include "notificationplanner.h"
 #include "timer.h"
 #include "persistent.h"
 #include "application.h"
@@ -39,6 +42,10 @@ inline void setupBackends() {
         qTimer->deleteLater();
     });
 
+    notifiable_on_change::set_post_hook([](std::function<void()> fn) {
+        QTimer::singleShot(0, std::move(fn));
+    });
+
     persistent_storage::backend::set_setter([](const std::string &key, const void *data, size_t size) {
         Application::currentSettings().setValue(key.c_str(), QByteArray((const char *) data, size));
     });
@@ -60,6 +67,10 @@ inline void setupBackends() {
         result_callback(value.toByteArray().data());
     });
 
+    notification_planner::backend::set_main_thread_dispatcher([](std::function<void()> fn) {
+        QMetaObject::invokeMethod(QCoreApplication::instance(), std::move(fn), Qt::QueuedConnection);
+    });
+
     user_notifications::backend::set_immediate_sender([](const user_notifications::notification &notification) {
         std::cout << "want to sent notification: " << notification << "\n";
         Application::notifierBackend().sendMessage(notification.title.c_str(),
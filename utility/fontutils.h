@@ -5,9 +5,13 @@
 #ifndef STRATEGR_FONTUTILS_H
 #define STRATEGR_FONTUTILS_H
 
+#include <optional>
+#include <string>
+
+#include <QFontMetrics>
 #include <QPainter>
+#include <QStaticText>
 #include <QStringList>
-#include <QFontMetrics>
 #include "session.h"
 #include "activity.h"
 #include "applicationsettings.h"
@@ -16,27 +20,41 @@
 #include "time_utils.h"
 
 namespace FontUtils {
-    inline void
-    drawSessionTitle(const stg::session &session,
-                     QPainter &painter,
-                     const QRect &rect,
-                     QColor durationColor = QColor(255, 255, 255, 0),
-                     QColor titleColor = QColor(255, 255, 255, 0)) {
+    // Session title laid out for a particular name, duration and width.
+    // Colors aren't part of the layout, so theme changes don't invalidate it.
+    // The font isn't checked, so owners reset the layout on font change.
+    struct SessionTitleLayout {
+        std::string name;
+        stg::session::minutes duration = 0;
+        int maximumWidth = 0;
+
+        QStaticText head;
+        QStaticText tail;
+        QSize wholeSize;
+        int headWidth = 0;
+
+        bool isMadeFor(const stg::session &session,
+                       const stg::activity &activity,
+                       int maximumWidth) const {
+            return this->maximumWidth == maximumWidth &&
+                   duration == session.duration() &&
+                   name == activity.name();
+        }
+    };
 
-        auto name = QString::fromStdString(session.activity->name());
+    inline SessionTitleLayout makeSessionTitleLayout(const stg::session &session,
+                                                     const stg::activity &activity,
+                                                     int maximumWidth,
+                                                     const QFont &font) {
         auto duration = QString::fromStdString(stg::time_utils::human_string_from_minutes(session.duration()));
 
-        auto textComponents = QStringList{duration, name};
-        auto head = textComponents.first() + " ";
-        auto tail = textComponents.last();
-        auto text = textComponents.join(" ");
+        auto head = duration + " ";
+        auto tail = QString::fromStdString(activity.name());
+        auto text = head + tail;
 
-        auto fontMetrics = QFontMetrics(painter.font());
+        auto fontMetrics = QFontMetrics(font);
         auto wholeSize = fontMetrics.size(Qt::TextSingleLine, text);
         auto headSize = fontMetrics.size(Qt::TextSingleLine, head);
-        auto tailSize = fontMetrics.size(Qt::TextSingleLine, tail);
-
-        auto maximumWidth = rect.width();
 
         if (wholeSize.width() >= maximumWidth) {
             tail = fontMetrics.elidedText(tail,
@@ -47,19 +65,42 @@ namespace FontUtils {
             wholeSize = fontMetrics.size(Qt::TextSingleLine, text);
         }
 
-        auto origin = QPoint(rect.x() + (rect.width() - wholeSize.width()) / 2,
-                             rect.y() + (rect.height() - wholeSize.height()) / 2);
+        auto layout = SessionTitleLayout();
+        layout.name = activity.name();
+        layout.duration = session.duration();
+        layout.maximumWidth = maximumWidth;
+        layout.head = QStaticText(head);
+        layout.tail = QStaticText(tail);
+        layout.wholeSize = wholeSize;
+        layout.headWidth = headSize.width();
+
+        for (auto *staticText : {&layout.head, &layout.tail}) {
+            staticText->setTextFormat(Qt::PlainText);
+            staticText->setPerformanceHint(QStaticText::AggressiveCaching);
+            staticText->prepare(QTransform(), font);
+        }
+
+        return layout;
+    }
 
-        auto durationRect = QRect(origin.x(),
-                                  origin.y(),
-                                  headSize.width(),
-                                  headSize.height());
+    // The cached layout is made again only if it doesn't fit the session or the rect,
+    // so repaints of the same session don't shape its title again.
+    inline void
+    drawSessionTitle(const stg::session &session,
+                     const stg::activity &activity,
+                     QPainter &painter,
+                     const QRect &rect,
+                     std::optional<SessionTitleLayout> &cachedLayout,
+                     QColor durationColor = QColor(255, 255, 255, 0),
+                     QColor titleColor = QColor(255, 255, 255, 0)) {
+        if (!cachedLayout || !cachedLayout->isMadeFor(session, activity, rect.width())) {
+            cachedLayout = makeSessionTitleLayout(session, activity, rect.width(), painter.font());
+        }
 
-        auto titleRect = QRect(origin.x() + headSize.width(),
-                               origin.y(),
-                               tailSize.width(),
-                               tailSize.height());
+        const auto &layout = *cachedLayout;
 
+        auto origin = QPoint(rect.x() + (rect.width() - layout.wholeSize.width()) / 2,
+                             rect.y() + (rect.height() - layout.wholeSize.height()) / 2);
 
         if (durationColor == QColor(255, 255, 255, 0))
             durationColor = ColorUtils::overlayWithAlpha(
@@ -68,20 +109,14 @@ namespace FontUtils {
 
         if (titleColor == QColor(255, 255, 255, 0))
             titleColor = ColorUtils::safeForegroundColor(
-                    ColorUtils::QColorFromStdString(session.activity->color())
+                    ColorUtils::QColorFromStdString(activity.color())
             );
 
-        auto thickFont = painter.font();
-        auto thinFont = painter.font();
-        thinFont.setBold(false);
-
-//        painter.setFont(thinFont);
         painter.setPen(durationColor);
-        painter.drawText(durationRect, head);
+        painter.drawStaticText(origin, layout.head);
 
-//        painter.setFont(thickFont);
         painter.setPen(titleColor);
-        painter.drawText(titleRect, tail);
+        painter.drawStaticText(origin + QPoint(layout.headWidth, 0), layout.tail);
 
         painter.setPen(Qt::NoPen);
     }